@@ -9,6 +9,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cstdint>
+
 struct LightSource final {
     glm::vec3 position{0.0f, 0.0f, 6.0f}; // z fixed
     glm::vec3 color{1.0f, 0.98f, 0.92f};
@@ -18,6 +20,10 @@ struct LightSource final {
 
     float planeZ = 0.0f;
 
+    // 变更计数：position / planeZ 改动后必须 touch()，阴影缓存靠它判断是否要重建
+    std::uint64_t version = 1;
+    void touch() { ++version; }
+
     glm::vec3 directionToPlaneCenter(const glm::vec2& centerXY = glm::vec2(0.0f)) const {
         glm::vec3 center(centerXY.x, centerXY.y, planeZ);
         return glm::normalize(center - position);
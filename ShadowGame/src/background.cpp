@@ -34,56 +34,53 @@ BackgroundPlane::~BackgroundPlane() {
     if (vao_) glDeleteVertexArrays(1, &vao_);
 }
 
-void BackgroundPlane::draw(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-                           const glm::vec2& lightCenter, float lightRadius, float softness,
-                           float ambient) const {
-    shader.use();
+void BackgroundPlane::draw(RenderState& rs, const Shader& shader, bool useLighting, float ambient) const {
+    shader.use(rs);
+    const Shader::HotUniforms& u = shader.hot();
 
     glm::mat4 m(1.0f);
-    shader.setMat4("uModel", m);
-    shader.setMat4("uView", view);
-    shader.setMat4("uProj", proj);
+    shader.setMat4(u.uModel, m);
 
     // ✅ 关键：每次画墙/地面都强制走 base 分支
-    shader.setInt("uMode", 1);
+    shader.setInt(u.uMode, 1);
 
-    shader.setVec3("uColor", color);
+    shader.setVec3(u.uColor, color);
 
-    // ✅ floor 那种 lightRadius=0 的情况不要参与光圈计算，避免 smoothstep(edge0=edge1) 未定义
-    const int useLighting = (lightRadius > 1e-4f && softness > 1e-4f) ? 1 : 0;
-    shader.setInt("uUseLighting", useLighting);
+    // ✅ floor 不参与光圈计算
+    shader.setInt(u.uUseLighting, useLighting ? 1 : 0);
+    shader.setFloat(u.uAmbient, ambient);
 
-    shader.setVec2("uLightCenter", lightCenter);
-    shader.setFloat("uLightRadius", lightRadius);
-    shader.setFloat("uSoftness", softness);
-    shader.setFloat("uAmbient", ambient);
-
-    glBindVertexArray(vao_);
+    rs.bindVertexArray(vao_);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
 }
 
 
-void BackgroundPlane::drawShadowCompositeFromMask(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-                                                 GLuint maskTex, const glm::ivec2& resolution,
+void BackgroundPlane::drawShadowCompositeFromMask(RenderState& rs, const Shader& shader, GLuint maskTex,
                                                  const glm::vec4& shadowColor) const {
-    shader.use();
+    shader.use(rs);
+    const Shader::HotUniforms& u = shader.hot();
 
-    shader.setMat4("uModel", glm::mat4(1.0f));
-    shader.setMat4("uView", view);
-    shader.setMat4("uProj", proj);
+    shader.setMat4(u.uModel, glm::mat4(1.0f));
+    shader.setInt(u.uMode, 6);
+    shader.setVec4(u.uColor4, shadowColor);
 
-    shader.setInt("uMode", 6);
-    shader.setVec2("uResolution", glm::vec2((float)resolution.x, (float)resolution.y));
-    shader.setVec4("uColor4", shadowColor);
+    rs.bindTexture2D(0, maskTex);   // uShadowMask 固定是 unit 0（Scene 构造时设好）
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, maskTex);
-    shader.setInt("uShadowMask", 0);
+    rs.bindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
 
-    glBindVertexArray(vao_);
+void BackgroundPlane::drawShadowStencilComposite(RenderState& rs, const Shader& shader,
+                                                 const glm::vec4& shadowColor) const {
+    shader.use(rs);
+    const Shader::HotUniforms& u = shader.hot();
+
+    shader.setMat4(u.uModel, glm::mat4(1.0f));
+    shader.setInt(u.uMode, 7);
+    shader.setVec4(u.uColor4, shadowColor);
+
+    rs.bindVertexArray(vao_);
     glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
 }
 
 BackgroundPlanes::BackgroundPlanes() {
@@ -94,20 +91,22 @@ BackgroundPlanes::BackgroundPlanes() {
 
 BackgroundPlanes::~BackgroundPlanes() = default;
 
-void BackgroundPlanes::drawWallLit(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-                                   const glm::vec2& lightCenter, float lightRadius, float softness,
-                                   float ambient) const {
-    wall_.draw(shader, view, proj, lightCenter, lightRadius, softness, ambient);
+void BackgroundPlanes::drawWallLit(RenderState& rs, const Shader& shader, float ambient) const {
+    wall_.draw(rs, shader, true, ambient);
 }
 
-void BackgroundPlanes::drawFloorFlat(const Shader& shader, const glm::mat4& view, const glm::mat4& proj) const {
+void BackgroundPlanes::drawFloorFlat(RenderState& rs, const Shader& shader) const {
     // floor: reuse same plane for now (you can later make a real floor at y=0 in 3D)
     // Here just draw nothing or keep as-is if you already have a separate floor plane.
-    floor_.draw(shader, view, proj, glm::vec2(0.0f), 0.0f, 0.0f, 1.0f);
+    floor_.draw(rs, shader, false, 1.0f);
 }
 
-void BackgroundPlanes::drawWallShadowCompositeFromMask(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-                                                      GLuint maskTex, const glm::ivec2& resolution,
+void BackgroundPlanes::drawWallShadowCompositeFromMask(RenderState& rs, const Shader& shader, GLuint maskTex,
                                                       const glm::vec4& shadowColor) const {
-    wall_.drawShadowCompositeFromMask(shader, view, proj, maskTex, resolution, shadowColor);
+    wall_.drawShadowCompositeFromMask(rs, shader, maskTex, shadowColor);
+}
+
+void BackgroundPlanes::drawWallShadowStencilComposite(RenderState& rs, const Shader& shader,
+                                                     const glm::vec4& shadowColor) const {
+    wall_.drawShadowStencilComposite(rs, shader, shadowColor);
 }
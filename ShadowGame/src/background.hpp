@@ -6,6 +6,7 @@
 #include <glm/glm.hpp>
 
 #include "object.hpp" // Shader
+#include "render_state.hpp"
 
 class BackgroundPlane final {
 public:
@@ -15,13 +16,13 @@ public:
     BackgroundPlane(const BackgroundPlane&) = delete;
     BackgroundPlane& operator=(const BackgroundPlane&) = delete;
 
-    void draw(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-              const glm::vec2& lightCenter, float lightRadius, float softness,
-              float ambient) const;
+    // view / proj / 光圈 / 分辨率都来自 FrameData；useLighting=false 时不做光圈
+    void draw(RenderState& rs, const Shader& shader, bool useLighting, float ambient) const;
 
-    void drawShadowCompositeFromMask(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-                                     GLuint maskTex, const glm::ivec2& resolution,
+    void drawShadowCompositeFromMask(RenderState& rs, const Shader& shader, GLuint maskTex,
                                      const glm::vec4& shadowColor) const;
+    // stencil 合成：调用方已把阴影标进 stencil 并设好 stencil test；光圈软边在这一遍里算
+    void drawShadowStencilComposite(RenderState& rs, const Shader& shader, const glm::vec4& shadowColor) const;
 
     glm::vec3 color{0.70f, 0.55f, 0.38f};
 
@@ -36,16 +37,15 @@ public:
 
     float deathY() const { return 0.0f; }
 
-    void drawWallLit(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-                     const glm::vec2& lightCenter, float lightRadius, float softness,
-                     float ambient) const;
+    void drawWallLit(RenderState& rs, const Shader& shader, float ambient) const;
 
-    void drawFloorFlat(const Shader& shader, const glm::mat4& view, const glm::mat4& proj) const;
+    void drawFloorFlat(RenderState& rs, const Shader& shader) const;
 
-    void drawWallShadowCompositeFromMask(const Shader& shader, const glm::mat4& view, const glm::mat4& proj,
-                                         GLuint maskTex, const glm::ivec2& resolution,
+    void drawWallShadowCompositeFromMask(RenderState& rs, const Shader& shader, GLuint maskTex,
                                          const glm::vec4& shadowColor) const;
 
+    void drawWallShadowStencilComposite(RenderState& rs, const Shader& shader, const glm::vec4& shadowColor) const;
+
 private:
     BackgroundPlane wall_;
     BackgroundPlane floor_;
@@ -0,0 +1,284 @@
+// ==============================
+// File: bench_main.cpp
+// 阴影 / 碰撞热点的微基准：不同场景规模 × 不同光源位置，报告 ns/op 与吞吐
+//   ShadowGame_bench [--filter rebuild] [--min-time 0.25] [--gen 100000 --density 0.05 ...]
+//   ShadowGame_bench --filter project --simd sse2  （批量投影强制走某条 SIMD 路径；默认按 CPU 选）
+//   ShadowGame_bench --filter rebuild --jobs 7   （整体重建额外跑一遍 7 个工作线程的并行版本）
+// 场景来自 level_gen（固定种子），不同规模之间可以直接比较
+// 数字只在 Release（-DCMAKE_BUILD_TYPE=Release）下有参考意义
+// ==============================
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "box.hpp"
+#include "collision.hpp"
+#include "job_system.hpp"
+#include "level_gen.hpp"
+#include "shadow.hpp"
+#include "shadow_geom.hpp"
+#include "shadow_simd.hpp"
+#include "world.hpp"
+
+namespace {
+
+// 防止结果被优化掉
+volatile float g_sink = 0.0f;
+
+double g_minTime = 0.25;          // 每个 case 至少跑这么久（秒）
+const char* g_filter = nullptr;   // 只跑名字里含这个子串的 kernel
+JobSystem* g_jobs = nullptr;      // --jobs：并行重建用
+
+struct LightCase {
+    const char* name;
+    glm::vec3 pos;
+};
+
+// 相对生成关卡光源出生点的偏移
+// near：正常游戏视角；far：光源很远，剪影接近平行投影；low：光源贴近盒子最前面，hull 拉得很长
+const LightCase kLights[] = {
+    {"near", glm::vec3(  0.0f,  0.0f,  0.0f)},
+    {"far",  glm::vec3(  4.0f, 20.0f, 48.0f)},
+    {"low",  glm::vec3(-14.0f, -6.0f, -3.0f)},
+};
+
+const int kSceneSizes[] = {16, 256, 4096, 65536};
+
+bool selected(const char* kernel) {
+    return !g_filter || std::strstr(kernel, g_filter) != nullptr;
+}
+
+// 跑 op(i) 直到累计时间 >= g_minTime；返回 ns/op
+template <class Op>
+double measure(int opsPerBatch, Op&& op) {
+    using clock = std::chrono::steady_clock;
+    for (int i = 0; i < opsPerBatch; ++i) op(i);   // warm-up
+
+    long long ops = 0;
+    double elapsed = 0.0;
+    const auto t0 = clock::now();
+    do {
+        for (int i = 0; i < opsPerBatch; ++i) op(i);
+        ops += opsPerBatch;
+        elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+    } while (elapsed < g_minTime);
+    return elapsed * 1e9 / (double)ops;
+}
+
+void report(const char* kernel, int boxes, const char* light, double nsPerOp, const char* unitName) {
+    // 吞吐量按量级选前缀：单个 kernel 是 M/s，整帧重建（几到几十 ms）只有几十 /s
+    double perSec = 1e9 / nsPerOp;
+    const char* prefix = "";
+    if (perSec >= 1e6) {
+        perSec *= 1e-6;
+        prefix = "M";
+    } else if (perSec >= 1e3) {
+        perSec *= 1e-3;
+        prefix = "k";
+    }
+    std::printf("%-24s %7d  %-5s %12.1f ns/op %12.3f %s%s/s\n",
+                kernel, boxes, light, nsPerOp, perSec, prefix, unitName);
+}
+
+void benchScene(const LevelGenParams& gen, const LightCase& lightCase) {
+    GeneratedLevel level = generateLevel(gen);
+    const int n = (int)level.objects.size();
+    const LightCase lc{lightCase.name, level.lightSpawn + lightCase.pos};
+
+    ShadowWorld world;
+    world.loadLevel(std::move(level.objects), level.lightSpawn);
+    world.setLightPosition(lc.pos);
+    world.rebuildShadowPlatforms();
+
+    const std::vector<BoxObject>& boxes = world.objects();
+    const HullPool& pool = world.platforms();
+
+    std::vector<glm::vec3> corners;
+    corners.reserve(boxes.size() * 8);
+    for (const BoxObject& b : boxes) {
+        glm::vec3 mn, mx;
+        b.worldBounds(mn, mx);
+        for (int c = 0; c < 8; ++c) corners.push_back(geom::boxCorner(mn, mx, c));
+    }
+
+    std::vector<int> slots;
+    for (int s = 0; s < pool.size(); ++s) if (pool.valid(s)) slots.push_back(s);
+    if (slots.empty()) return;
+    const int ns = (int)slots.size();
+
+    if (selected("projectToWallZ0")) {
+        const int m = (int)corners.size();
+        report("projectToWallZ0", n, lc.name, measure(m, [&](int i) {
+            g_sink = g_sink + geom::projectToWallZ0(lc.pos, corners[(size_t)i]).x;
+        }), "pt");
+    }
+
+    // 一次一批 kProjectBatch 个盒子：8 个角点生成 + 投影，每条 CPU 支持的路径各跑一遍
+    if (selected("projectBoxBatch")) {
+        const int batches = (n + geom::kProjectBatch - 1) / geom::kProjectBatch;
+        std::vector<geom::BoxBatchSoA> in((size_t)batches);
+        for (int i = 0; i < n; ++i) {
+            geom::BoxBatchSoA& b = in[(size_t)(i / geom::kProjectBatch)];
+            const int k = b.count++;
+            b.cx[k] = boxes[(size_t)i].position.x;
+            b.cy[k] = boxes[(size_t)i].position.y;
+            b.cz[k] = boxes[(size_t)i].position.z;
+            b.hx[k] = 0.5f * boxes[(size_t)i].scale.x;
+            b.hy[k] = 0.5f * boxes[(size_t)i].scale.y;
+            b.hz[k] = 0.5f * boxes[(size_t)i].scale.z;
+        }
+        geom::ProjectedBatchSoA out;
+        const geom::SimdPath chosen = geom::activeSimdPath();
+        for (int p = 0; p <= (int)chosen; ++p) {
+            geom::setSimdPath((geom::SimdPath)p);
+            char name[40];
+            std::snprintf(name, sizeof(name), "projectBoxBatch/%s", geom::simdPathName((geom::SimdPath)p));
+            const double nsPerBatch = measure(batches, [&](int i) {
+                geom::projectBoxBatch(lc.pos, in[(size_t)i], out);
+                g_sink = g_sink + out.x[1][1][0];
+            });
+            report(name, n, lc.name, nsPerBatch * (double)batches / (double)n, "box");
+        }
+        geom::setSimdPath(chosen);
+    }
+
+    if (selected("boxSilhouetteOnWall")) {
+        report("boxSilhouetteOnWall", n, lc.name, measure(n, [&](int i) {
+            glm::vec2 out[geom::kMaxSilhouetteVerts];
+            g_sink = g_sink + (float)geom::boxSilhouetteOnWall(lc.pos, corners[(size_t)i * 8], corners[(size_t)i * 8 + 7], out);
+        }), "box");
+    }
+
+    if (selected("convexHull")) {
+        std::vector<glm::vec2> projected(corners.size());
+        for (size_t i = 0; i < corners.size(); ++i) projected[i] = geom::projectToWallZ0(lc.pos, corners[i]);
+        report("ShadowWorld::convexHull", n, lc.name, measure(n, [&](int i) {
+            ShadowWorld::HullPoints pts(projected.begin() + i * 8, projected.begin() + i * 8 + 8);
+            g_sink = g_sink + (float)ShadowWorld::convexHull(std::move(pts)).size();
+        }), "hull");
+    }
+
+    if (selected("topYAtX")) {
+        report("ShadowWorld::topYAtX", n, lc.name, measure(ns, [&](int i) {
+            const int s = slots[(size_t)i];
+            float y = 0.0f;
+            ShadowWorld::topYAtX(pool.verts(s), pool.count(s), 0.5f * (pool.minX(s) + pool.maxX(s)), y);
+            g_sink = g_sink + y;
+        }), "q");
+        report("ShadowBall::topYAtX", n, lc.name, measure(ns, [&](int i) {
+            const int s = slots[(size_t)i];
+            float y = 0.0f;
+            ShadowBall::topYAtX(pool.verts(s), pool.count(s), 0.5f * (pool.minX(s) + pool.maxX(s)), y);
+            g_sink = g_sink + y;
+        }), "q");
+    }
+
+    // 圆心放在 hull 左边缘附近：一半相交、一半只过包围圆粗筛
+    if (selected("mtvCirclePoly")) {
+        report("collision::mtvCirclePoly", n, lc.name, measure(ns, [&](int i) {
+            const int s = slots[(size_t)i];
+            const glm::vec2 c(pool.minX(s) + ((i & 1) ? 0.1f : -0.3f), 0.5f * (pool.minY(s) + pool.maxY(s)));
+            glm::vec2 mtv(0.0f);
+            collision::mtvCirclePoly(c, 0.22f, pool.view(s), mtv);
+            g_sink = g_sink + mtv.x;
+        }), "q");
+    }
+
+    // 球从左侧横着撞进 side 边：prev 在外、pos 压进去
+    if (selected("preventEnterSideWalls")) {
+        report("preventEnterSideWalls", n, lc.name, measure(ns, [&](int i) {
+            const int s = slots[(size_t)i];
+            const float y = 0.5f * (pool.minY(s) + pool.maxY(s));
+            const glm::vec2 prev(pool.minX(s) - 0.5f, y);
+            glm::vec2 pos(pool.minX(s) + 0.05f, y);
+            glm::vec2 vel(4.2f, 0.0f);
+            ShadowBall::preventEnterSideWalls(pool.view(s), prev, pos, vel, 0.22f);
+            g_sink = g_sink + pos.x;
+        }), "q");
+    }
+
+    // 单独的圆-边穿透 kernel：同样的圆心，每条 SIMD 路径各跑一遍（往上走，side + ceiling 都算）
+    if (selected("deepestEdgePenetration")) {
+        const geom::SimdPath chosen = geom::activeSimdPath();
+        for (int p = 0; p <= (int)chosen; ++p) {
+            geom::setSimdPath((geom::SimdPath)p);
+            char name[48];
+            std::snprintf(name, sizeof(name), "deepestEdgePen/%s", geom::simdPathName((geom::SimdPath)p));
+            report(name, n, lc.name, measure(ns, [&](int i) {
+                const int s = slots[(size_t)i];
+                const HullView v = pool.view(s);
+                const glm::vec2 c(pool.minX(s) + 0.05f, 0.5f * (pool.minY(s) + pool.maxY(s)));
+                g_sink = g_sink + geom::deepestEdgePenetration(v, v.wallMaskRising, c, 0.22f).depth;
+            }), "q");
+        }
+        geom::setSimdPath(chosen);
+    }
+
+    // 整体重建：每次 touch 光源，所有 hull 都要重算（查表剪影 + SoA 写入 + 网格）
+    if (selected("rebuildShadowPlatforms")) {
+        const double nsPerRebuild = measure(1, [&](int) {
+            world.setLightPosition(lc.pos);
+            world.rebuildShadowPlatforms();
+        });
+        report("rebuildShadowPlatforms", n, lc.name, nsPerRebuild, "rebuild");
+        report("  per box", n, lc.name, nsPerRebuild / (double)n, "box");
+
+        if (g_jobs) {
+            world.setJobSystem(g_jobs);
+            const double nsParallel = measure(1, [&](int) {
+                world.setLightPosition(lc.pos);
+                world.rebuildShadowPlatforms();
+            });
+            world.setJobSystem(nullptr);
+            report("  parallel", n, lc.name, nsParallel, "rebuild");
+            std::printf("%-24s %7d  %-5s %12.2fx on %d threads\n", "  speedup", n, lc.name,
+                        nsPerRebuild / nsParallel, g_jobs->concurrency());
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LevelGenParams gen;
+    bool singleSize = false;
+    int jobWorkers = 0;
+    geom::SimdPath simd = geom::detectSimdPath();
+    for (int i = 1; i < argc; ++i) {
+        if (parseLevelGenArg(argc, argv, i, gen, singleSize)) continue;
+        if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) g_filter = argv[++i];
+        else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) g_minTime = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--jobs") && i + 1 < argc) jobWorkers = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--simd") && i + 1 < argc && geom::parseSimdPath(argv[i + 1], simd)) ++i;
+        else {
+            std::fprintf(stderr, "usage: %s [--filter SUBSTR] [--min-time SECONDS] [--jobs WORKERS] [--simd scalar|sse2|avx]\n"
+                                 "          [--gen N] [--seed S] [--density D] [--heights uniform|short|tall|bimodal] [--overlap F]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    geom::setSimdPath(simd);
+    std::printf("simd: %s (cpu supports %s)\n", geom::simdPathName(geom::activeSimdPath()),
+                geom::simdPathName(geom::detectSimdPath()));
+    JobSystem jobs(jobWorkers);
+    if (jobWorkers > 0) g_jobs = &jobs;
+
+#ifndef NDEBUG
+    std::printf("note: assertions enabled (non-Release build), timings are not representative\n");
+#endif
+    std::printf("%-24s %7s  %-5s %18s %18s\n", "kernel", "boxes", "light", "time", "throughput");
+    // --gen N：只跑这一种规模；否则按 kSceneSizes 扫一遍（其余生成参数照样生效）
+    std::vector<int> sizes(std::begin(kSceneSizes), std::end(kSceneSizes));
+    if (singleSize) sizes.assign(1, gen.count);
+
+    for (int n : sizes) {
+        gen.count = n;
+        for (const LightCase& lc : kLights) benchScene(gen, lc);
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+// ============================================================================
+// File: src/box.cpp
+// ============================================================================
+#include "box.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+glm::mat4 BoxObject::model() const {
+    glm::mat4 m(1.0f);
+    m = glm::translate(m, position);
+    m = glm::scale(m, scale);
+    return m;
+}
+
+std::array<glm::vec3, 8> BoxObject::worldCorners() const {
+    const glm::mat4 m = model();
+    const std::array<glm::vec3, 8> local = {
+        glm::vec3(-0.5f, -0.5f, -0.5f),
+        glm::vec3( 0.5f, -0.5f, -0.5f),
+        glm::vec3( 0.5f,  0.5f, -0.5f),
+        glm::vec3(-0.5f,  0.5f, -0.5f),
+        glm::vec3(-0.5f, -0.5f,  0.5f),
+        glm::vec3( 0.5f, -0.5f,  0.5f),
+        glm::vec3( 0.5f,  0.5f,  0.5f),
+        glm::vec3(-0.5f,  0.5f,  0.5f),
+    };
+
+    std::array<glm::vec3, 8> out{};
+    for (int i = 0; i < 8; ++i) {
+        const glm::vec4 wp = m * glm::vec4(local[i], 1.0f);
+        out[i] = glm::vec3(wp);
+    }
+    return out;
+}
+
+void BoxObject::worldBounds(glm::vec3& outMin, glm::vec3& outMax) const {
+    const glm::vec3 a = position - 0.5f * scale;
+    const glm::vec3 b = position + 0.5f * scale;
+    outMin = glm::min(a, b);
+    outMax = glm::max(a, b);
+}
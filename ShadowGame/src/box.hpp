@@ -0,0 +1,34 @@
+// ============================================================================
+// File: src/box.hpp
+// 场景里的盒子：只有几何和颜色，不碰 GL（绘制在 object.hpp 的 BoxMesh）
+// ============================================================================
+#pragma once
+#ifndef BOX_HPP
+#define BOX_HPP
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+
+class BoxObject final {
+public:
+    glm::vec3 position{0.0f};
+    glm::vec3 scale{1.0f};
+    glm::vec3 color{0.8f, 0.8f, 0.85f};
+
+    // 变换计数：position / scale 改动后 touch()，阴影缓存按它判断该盒子的 hull 是否过期
+    std::uint32_t transformVersion = 0;
+    void touch() { ++transformVersion; }
+
+    BoxObject() = default;
+    BoxObject(const glm::vec3& p, const glm::vec3& s, const glm::vec3& c)
+        : position(p), scale(s), color(c) {}
+
+    glm::mat4 model() const;
+    std::array<glm::vec3, 8> worldCorners() const;
+    // 轴对齐包围盒（model 只有平移+缩放，所以就是盒子本身）
+    void worldBounds(glm::vec3& outMin, glm::vec3& outMax) const;
+};
+
+#endif // BOX_HPP
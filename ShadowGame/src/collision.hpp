@@ -0,0 +1,54 @@
+// ============================================================================
+// File: src/collision.hpp
+// 圆 vs 阴影 hull 的碰撞查询（实现在 collision_detect.cpp）
+// ============================================================================
+#pragma once
+#ifndef COLLISION_HPP
+#define COLLISION_HPP
+
+#include <glm/glm.hpp>
+
+#include "hull_grid.hpp"
+#include "hull_pool.hpp"
+
+namespace collision {
+
+// 边的分类（按单位外法线）：
+//   side    : |n.x| > 0.6
+//   ceiling : n.y < -0.6（外法线朝下，从下方撞上去的“天花板”）
+//   top     : n.y > 0 且不是 side（可站立的顶面）
+enum EdgeKind : unsigned {
+    kEdgeSide    = 1u,
+    kEdgeCeiling = 2u,
+    kEdgeTop     = 4u,
+};
+
+unsigned edgeKind(const glm::vec2& outwardNormal);
+
+// 扫掠结果：圆心沿 d 走到 t（d 的比例）时第一次接触
+struct SweepHit {
+    float t = 1.0f;
+    glm::vec2 normal{0.0f};   // 从接触特征指向圆心
+    int slot = -1;
+    int edge = -1;
+    unsigned kind = 0;
+};
+
+// 连续碰撞：圆心 p0 沿 d 移动，对 hull 中“种类是 kinds 子集”的每条边做胶囊（平移边 + 两端圆角）求交。
+// 起点已经压进某条边的胶囊时跳过这条边（只处理“外 -> 内”），命中更早时更新 ioHit 并返回 true。
+bool sweepCircleHull(const HullView& hull, int slot,
+                     const glm::vec2& p0, const glm::vec2& d, float r,
+                     unsigned kinds, SweepHit& ioHit);
+
+// SAT：圆与凸 hull 相交时给出把圆推出去的最小平移向量
+bool mtvCirclePoly(glm::vec2 pos, float r, const HullView& poly, glm::vec2& outMtv);
+
+// one-way platform resolve：只提供顶面支撑，返回 groundObjectId
+glm::vec2 resolveCircleAgainstPlatforms(glm::vec2 pos, float radius,
+                                       const HullPool& platforms,
+                                       const HullGrid& grid,
+                                       glm::vec2& vel, bool& grounded, int& groundObjectId);
+
+} // namespace collision
+
+#endif // COLLISION_HPP
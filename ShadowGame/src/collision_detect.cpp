@@ -1,4 +1,5 @@
-#include "scene.hpp"
+#include "collision.hpp"
+
 #include <algorithm>
 #include <cmath>
 #include <limits>
@@ -6,7 +7,6 @@
 namespace collision {
 
 static float dot2(const glm::vec2& a, const glm::vec2& b) { return a.x*b.x + a.y*b.y; }
-static glm::vec2 perp(const glm::vec2& v) { return glm::vec2(-v.y, v.x); }
 
 static glm::vec2 normalizeSafe(const glm::vec2& v) {
     const float l2 = dot2(v, v);
@@ -14,10 +14,10 @@ static glm::vec2 normalizeSafe(const glm::vec2& v) {
     return v / std::sqrt(l2);
 }
 
-static void projectPoly(const std::vector<glm::vec2>& p, const glm::vec2& axis, float& mn, float& mx) {
-    mn = mx = dot2(p[0], axis);
-    for (size_t i=1;i<p.size();++i) {
-        const float v = dot2(p[i], axis);
+static void projectPoly(const HullView& p, const glm::vec2& axis, float& mn, float& mx) {
+    mn = mx = dot2(p.verts[0], axis);
+    for (int i=1;i<p.count;++i) {
+        const float v = dot2(p.verts[i], axis);
         mn = std::min(mn, v);
         mx = std::max(mx, v);
     }
@@ -29,7 +29,7 @@ static void projectCircle(const glm::vec2& c, float r, const glm::vec2& axis, fl
     mx = p + r;
 }
 
-static bool overlapOnAxis(const std::vector<glm::vec2>& poly, const glm::vec2& c, float r,
+static bool overlapOnAxis(const HullView& poly, const glm::vec2& c, float r,
                           const glm::vec2& axis, float& outOverlap, float& outSign) {
     float pMin, pMax, cMin, cMax;
     projectPoly(poly, axis, pMin, pMax);
@@ -45,18 +45,21 @@ static bool overlapOnAxis(const std::vector<glm::vec2>& poly, const glm::vec2& c
 }
 
 // SAT MTV for circle vs convex poly
-static bool mtvCirclePoly(glm::vec2 pos, float r, const std::vector<glm::vec2>& poly, glm::vec2& outMtv) {
-    if (poly.size() < 3) return false;
+bool mtvCirclePoly(glm::vec2 pos, float r, const HullView& poly, glm::vec2& outMtv) {
+    if (!poly.valid()) return false;
+
+    // 包围圆粗筛
+    const glm::vec2 dc = pos - poly.center;
+    const float reach = poly.radius + r;
+    if (dot2(dc, dc) > reach * reach) return false;
 
     float minOverlap = std::numeric_limits<float>::infinity();
     glm::vec2 bestAxis(0.0f);
     float bestSign = 1.0f;
 
-    // edge normals
-    for (size_t i=0;i<poly.size();++i) {
-        const glm::vec2 a = poly[i];
-        const glm::vec2 b = poly[(i+1)%poly.size()];
-        const glm::vec2 axis = normalizeSafe(perp(b-a));
+    // edge normals（重建时预计算；SAT 只关心轴的方向线，外法线与 perp 等价）
+    for (int i=0;i<poly.count;++i) {
+        const glm::vec2 axis = poly.normals[i];
 
         float overlap=0.0f, sign=1.0f;
         if (!overlapOnAxis(poly, pos, r, axis, overlap, sign)) return false;
@@ -64,13 +67,13 @@ static bool mtvCirclePoly(glm::vec2 pos, float r, const std::vector<glm::vec2>&
     }
 
     // vertex axis
-    size_t bestV = 0;
+    int bestV = 0;
     float bestD = std::numeric_limits<float>::infinity();
-    for (size_t i=0;i<poly.size();++i) {
-        const float d = dot2(poly[i]-pos, poly[i]-pos);
+    for (int i=0;i<poly.count;++i) {
+        const float d = dot2(poly.verts[i]-pos, poly.verts[i]-pos);
         if (d < bestD) { bestD = d; bestV = i; }
     }
-    const glm::vec2 vAxis = normalizeSafe(pos - poly[bestV]);
+    const glm::vec2 vAxis = normalizeSafe(pos - poly.verts[bestV]);
     {
         float overlap=0.0f, sign=1.0f;
         if (overlapOnAxis(poly, pos, r, vAxis, overlap, sign)) {
@@ -82,10 +85,118 @@ static bool mtvCirclePoly(glm::vec2 pos, float r, const std::vector<glm::vec2>&
     return true;
 }
 
+unsigned edgeKind(const glm::vec2& n) {
+    unsigned k = 0;
+    if (std::fabs(n.x) > 0.6f) k |= kEdgeSide;
+    if (n.y < -0.6f) k |= kEdgeCeiling;
+    if (n.y > 0.0f && !(k & kEdgeSide)) k |= kEdgeTop;
+    return k;
+}
+
+// 射线 p0 + s*d 打圆 (v, r)；起点在圆内返回 false
+static bool rayCircle(const glm::vec2& p0, const glm::vec2& d, const glm::vec2& v, float r, float& outS) {
+    const glm::vec2 m = p0 - v;
+    const float b = dot2(m, d);
+    if (b >= 0.0f) return false;           // 远离
+    const float c = dot2(m, m) - r * r;
+    if (c < 0.0f) { outS = 0.0f; return true; }   // 只会是贴着的容差带（更深的已被调用方跳过）
+    const float a = dot2(d, d);
+    if (a < 1e-12f) return false;
+    const float disc = b * b - a * c;
+    if (disc < 0.0f) return false;
+    outS = (-b - std::sqrt(disc)) / a;
+    return true;
+}
+
+bool sweepCircleHull(const HullView& hull, int slot,
+                     const glm::vec2& p0, const glm::vec2& d, float r,
+                     unsigned kinds, SweepHit& ioHit) {
+    if (!hull.valid()) return false;
+
+    // 包围圆粗筛：扫掠线段到圆心的距离
+    {
+        const glm::vec2 m = hull.center - p0;
+        const float dd = dot2(d, d);
+        const float s = (dd > 1e-12f) ? std::clamp(dot2(m, d) / dd, 0.0f, 1.0f) : 0.0f;
+        const glm::vec2 q = p0 + d * s - hull.center;
+        const float reach = hull.radius + r;
+        if (dot2(q, q) > reach * reach) return false;
+    }
+
+    const float touchTol = 1e-4f;   // 允许“刚好贴着”的起点（推出后留的 skin）仍然算外部
+    bool any = false;
+
+    // 同一时刻命中多个特征（共享顶点）时顶面优先：球压着角落下落应当落地，而不是被侧边推开
+    auto earlier = [&](float s, unsigned k) {
+        return s < ioHit.t || (s == ioHit.t && (k & kEdgeTop) && !(ioHit.kind & kEdgeTop));
+    };
+
+    for (int i = 0; i < hull.count; ++i) {
+        const glm::vec2 n = hull.normals[i];
+        const unsigned k = edgeKind(n);
+        if (k == 0 || (k & ~kinds) != 0) continue;
+
+        const glm::vec2 a = hull.verts[i];
+        const glm::vec2 b = hull.verts[(i + 1) % hull.count];
+        const glm::vec2 e = b - a;
+        const float e2 = dot2(e, e);
+        if (e2 < 1e-10f) continue;
+
+        // 起点在这条边的背面（球心在 hull 里，和别的平台重叠时常见）：背面不挡，
+        // 否则会在 t=0 命中顶面 / 天花板 / 侧边的背面，球被吸到顶上或卡住
+        if (dot2(p0 - a, n) < -r + touchTol) continue;
+
+        // 起点已在胶囊内（压进去了）：不归扫掠管，交给离散兜底
+        {
+            const float u = std::clamp(dot2(p0 - a, e) / e2, 0.0f, 1.0f);
+            const glm::vec2 c = a + e * u;
+            const glm::vec2 pc = p0 - c;
+            const float rin = r - touchTol;
+            if (dot2(pc, pc) < rin * rin) continue;
+        }
+
+        // 平移边：只有朝着外法线反方向运动才可能撞上
+        const float dn = dot2(d, n);
+        if (dn < 0.0f) {
+            const float dist0 = dot2(p0 - a, n) - r;
+            const float s = std::max(dist0, 0.0f) / -dn;
+            if (s <= 1.0f && (ioHit.slot < 0 || earlier(s, k))) {
+                const glm::vec2 q = p0 + d * s;
+                const float u = dot2(q - a, e) / e2;
+                if (u >= 0.0f && u <= 1.0f) {
+                    ioHit.t = s;
+                    ioHit.normal = n;
+                    ioHit.slot = slot;
+                    ioHit.edge = i;
+                    ioHit.kind = k;
+                    any = true;
+                    continue;   // 面命中一定早于同一条边的端点命中
+                }
+            }
+        }
+
+        // 两端圆角
+        const glm::vec2 ends[2] = {a, b};
+        for (const glm::vec2& v : ends) {
+            float s = 0.0f;
+            if (!rayCircle(p0, d, v, r, s) || s > 1.0f) continue;
+            if (ioHit.slot >= 0 && !earlier(std::max(s, 0.0f), k)) continue;
+            ioHit.t = std::max(s, 0.0f);
+            ioHit.normal = normalizeSafe(p0 + d * ioHit.t - v);
+            ioHit.slot = slot;
+            ioHit.edge = i;
+            ioHit.kind = k;
+            any = true;
+        }
+    }
+    return any;
+}
+
 // One-way platform resolve:
 // 只在“球向下运动/落下”时，对 mtv.y>0 的情况提供支撑；不做 mtv.x 推回 -> 不会卡边
 glm::vec2 resolveCircleAgainstPlatforms(glm::vec2 pos, float radius,
-                                       const std::vector<ShadowPoly>& platforms,
+                                       const HullPool& platforms,
+                                       const HullGrid& grid,
                                        glm::vec2& vel, bool& grounded, int& groundObjectId) {
     grounded = false;
     groundObjectId = -1;
@@ -95,11 +206,10 @@ glm::vec2 resolveCircleAgainstPlatforms(glm::vec2 pos, float radius,
     for (int iter=0; iter<4; ++iter) {
         bool any = false;
 
-        for (const auto& pl : platforms) {
-            if (pl.hull.size() < 3) continue;
-
+        const glm::vec2 p0 = pos;
+        grid.query(p0.x - radius, p0.y - radius, p0.x + radius, p0.y + radius, [&](int slot) {
             glm::vec2 mtv(0.0f);
-            if (!mtvCirclePoly(pos, radius, pl.hull, mtv)) continue;
+            if (!mtvCirclePoly(pos, radius, platforms.view(slot), mtv)) return;
 
             // only resolve "standing" collisions
             if (mtv.y > 0.0f && vel.y <= 0.0f) {
@@ -110,11 +220,11 @@ glm::vec2 resolveCircleAgainstPlatforms(glm::vec2 pos, float radius,
                 grounded = true;
                 if (mtv.y > bestUp) {
                     bestUp = mtv.y;
-                    groundObjectId = pl.objectId;
+                    groundObjectId = platforms.objectId(slot);
                 }
             }
             // ignore side/underside pushes to allow falling off edges
-        }
+        });
 
         if (!any) break;
     }
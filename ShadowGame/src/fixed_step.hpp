@@ -0,0 +1,50 @@
+// ============================================================================
+// File: src/fixed_step.hpp
+// 固定步长模拟时钟：渲染帧的真实 dt 进累加器，按固定 tick 消耗；
+// 剩余的不足一个 tick 的时间给渲染做插值。
+// ============================================================================
+#pragma once
+#ifndef FIXED_STEP_HPP
+#define FIXED_STEP_HPP
+
+#include <algorithm>
+
+class FixedStepClock final {
+public:
+    explicit FixedStepClock(double tickHz = 120.0, int maxStepsPerFrame = 8) {
+        setTickRate(tickHz);
+        setMaxStepsPerFrame(maxStepsPerFrame);
+    }
+
+    void setTickRate(double hz) { tickDt_ = 1.0 / std::max(hz, 1.0); }
+    void setMaxStepsPerFrame(int n) { maxSteps_ = std::max(n, 1); }
+
+    double tickDt() const { return tickDt_; }
+    int maxStepsPerFrame() const { return maxSteps_; }
+
+    // 累加本帧真实时间，返回本帧要跑的 tick 数。
+    // 卡顿时最多跑 maxSteps 个，多出来的时间直接丢掉（宁可慢动作也不穿模/雪崩）
+    int advance(double frameDt) {
+        accumulator_ += std::max(frameDt, 0.0);
+        int steps = (int)(accumulator_ / tickDt_);
+        if (steps > maxSteps_) {
+            steps = maxSteps_;
+            accumulator_ = 0.0;
+        } else {
+            accumulator_ -= steps * tickDt_;
+        }
+        return steps;
+    }
+
+    // 上一个 tick 到下一个 tick 之间的位置 [0,1)，渲染用
+    float alpha() const { return (float)std::clamp(accumulator_ / tickDt_, 0.0, 1.0); }
+
+    void reset() { accumulator_ = 0.0; }
+
+private:
+    double tickDt_ = 1.0 / 120.0;
+    double accumulator_ = 0.0;
+    int maxSteps_ = 8;
+};
+
+#endif // FIXED_STEP_HPP
@@ -0,0 +1,57 @@
+// File: src/frame_arena.cpp
+#include "frame_arena.hpp"
+
+#include <algorithm>
+
+FrameArena::FrameArena(std::size_t blockBytes) : blockBytes_(std::max<std::size_t>(blockBytes, 256)) {}
+
+std::pmr::memory_resource* FrameArena::resource() {
+#ifdef SHADOWGAME_FRAME_ARENA
+    return this;
+#else
+    return std::pmr::new_delete_resource();
+#endif
+}
+
+void FrameArena::reset() {
+    cur_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+void FrameArena::rewind(Marker m) {
+    // 只能往回拨：m 之后才启用的块里的东西一起作废
+    if (m.block > cur_ || (m.block == cur_ && m.offset > offset_)) return;
+    for (std::size_t b = m.block; b < cur_; ++b) used_ -= blocks_[b].size;
+    cur_ = m.block;
+    offset_ = m.offset;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t align) {
+    for (;;) {
+        if (cur_ < blocks_.size()) {
+            Block& b = blocks_[cur_];
+            const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(b.data.get());
+            const std::uintptr_t p = (base + offset_ + (align - 1)) & ~(std::uintptr_t)(align - 1);
+            const std::size_t end = (std::size_t)(p - base) + bytes;
+            if (end <= b.size) {
+                offset_ = end;
+                highWater_ = std::max(highWater_, used_ + offset_);
+                return reinterpret_cast<void*>(p);
+            }
+            // 当前块放不下：跳到下一块（已有的块如果太小就继续跳，浪费一点没关系）
+            used_ += b.size;
+            ++cur_;
+            offset_ = 0;
+            continue;
+        }
+
+        // 后面没有块了：向系统要一块，之后 reset 也不还
+        Block nb;
+        nb.size = std::max(blockBytes_, bytes + align);
+        nb.data = std::make_unique<std::byte[]>(nb.size);
+        blocks_.push_back(std::move(nb));
+        cur_ = blocks_.size() - 1;
+        ++blockAllocs_;
+    }
+}
@@ -0,0 +1,77 @@
+// ============================================================================
+// File: src/frame_arena.hpp
+// 帧内临时内存：bump 分配的 std::pmr::memory_resource。deallocate 什么都不做，
+// reset() 把游标拨回第一块开头；块只增不还，稳态下一帧的临时 vector 不再碰 malloc。
+// mark()/rewind()（或 Scope）可以在帧内把一段用完的临时空间立刻收回来（逐个 hull 的 scratch）。
+//
+// 非线程安全：并行重建时每个 worker 一个。
+// CMake -DSHADOWGAME_FRAME_ARENA=OFF 时 resource() 直接给 new_delete_resource()，用来对比原来的分配器。
+// ============================================================================
+#pragma once
+#ifndef FRAME_ARENA_HPP
+#define FRAME_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+class FrameArena final : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(std::size_t blockBytes = 16 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 临时容器该用的 resource：编译期关掉 arena 时是全局 new/delete
+    std::pmr::memory_resource* resource();
+
+    // 帧开始：全部空间作废，块保留下次复用
+    void reset();
+
+    struct Marker {
+        std::size_t block = 0;
+        std::size_t offset = 0;
+    };
+    Marker mark() const { return Marker{cur_, offset_}; }
+    // 回到 mark 时的位置；之后分配的东西全部作废
+    void rewind(Marker m);
+
+    // 作用域：析构时 rewind 到构造时的位置
+    class Scope final {
+    public:
+        explicit Scope(FrameArena& a) : arena_(a), mark_(a.mark()) {}
+        ~Scope() { arena_.rewind(mark_); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena& arena_;
+        Marker mark_;
+    };
+
+    // 自创建以来同时占用的最大字节数 / 向系统要块的次数（稳态下应当不再增长）
+    std::size_t highWater() const { return highWater_; }
+    std::uint64_t blockAllocs() const { return blockAllocs_; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size = 0;
+    };
+
+    std::size_t blockBytes_;
+    std::vector<Block> blocks_;
+    std::size_t cur_ = 0;          // 当前块
+    std::size_t offset_ = 0;       // 当前块内游标
+    std::size_t used_ = 0;         // 之前各块已用掉的字节（算 highWater 用）
+    std::size_t highWater_ = 0;
+    std::uint64_t blockAllocs_ = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+#endif // FRAME_ARENA_HPP
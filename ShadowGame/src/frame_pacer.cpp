@@ -0,0 +1,141 @@
+// File: src/frame_pacer.cpp
+#include "frame_pacer.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+bool parsePaceMode(const char* s, PaceMode& out) {
+    if (!std::strcmp(s, "vsync"))    { out = PaceMode::Vsync;    return true; }
+    if (!std::strcmp(s, "uncapped")) { out = PaceMode::Uncapped; return true; }
+    if (!std::strcmp(s, "adaptive")) { out = PaceMode::Adaptive; return true; }
+    if (!std::strcmp(s, "limit"))    { out = PaceMode::Limiter;  return true; }
+    return false;
+}
+
+const char* paceModeName(PaceMode m) {
+    switch (m) {
+        case PaceMode::Vsync:    return "vsync";
+        case PaceMode::Uncapped: return "uncapped";
+        case PaceMode::Adaptive: return "adaptive";
+        case PaceMode::Limiter:  return "limit";
+    }
+    return "?";
+}
+
+FramePacer::FramePacer(const FramePacerConfig& cfg)
+    : mode_(cfg.mode),
+      targetFps_(std::max(cfg.targetFps, 1.0)),
+      maxInFlight_(std::clamp(cfg.maxFramesInFlight, 0, kMaxFramesInFlight)) {
+
+    if (mode_ == PaceMode::Adaptive &&
+        !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        mode_ = PaceMode::Vsync;
+    }
+
+    switch (mode_) {
+        case PaceMode::Vsync:    glfwSwapInterval(1);  break;
+        case PaceMode::Adaptive: glfwSwapInterval(-1); break;
+        case PaceMode::Uncapped:
+        case PaceMode::Limiter:  glfwSwapInterval(0);  break;
+    }
+
+    period_ = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps_));
+}
+
+FramePacer::~FramePacer() {
+    for (GLsync& f : fences_) {
+        if (f) glDeleteSync(f);
+        f = nullptr;
+    }
+}
+
+std::string FramePacer::describe() const {
+    std::ostringstream os;
+    os << paceModeName(mode_);
+    if (mode_ == PaceMode::Limiter) os << " @ " << targetFps_ << " fps";
+    if (maxInFlight_ > 0) os << ", max " << maxInFlight_ << " frame(s) in flight";
+    else os << ", frames in flight unbounded";
+    return os.str();
+}
+
+// 睡到离截止时间 ~1.5ms，剩下的自旋（sleep 的粒度在不少系统上是 1ms 级）
+void FramePacer::limit() {
+    const auto spinMargin = std::chrono::microseconds(1500);
+    const Clock::time_point now = Clock::now();
+    if (!started_) {
+        deadline_ = now + period_;
+        return;
+    }
+    if (deadline_ - now > spinMargin) std::this_thread::sleep_for(deadline_ - now - spinMargin);
+    while (Clock::now() < deadline_) std::this_thread::yield();
+
+    // 落后超过一帧就不补了，从现在重新对齐（否则卡顿后会连续快速出帧）
+    deadline_ += period_;
+    const Clock::time_point after = Clock::now();
+    if (after > deadline_) deadline_ = after + period_;
+}
+
+void FramePacer::waitFramesInFlight() {
+    if (maxInFlight_ <= 0) return;
+    while (fenceCount_ >= maxInFlight_) {
+        const int oldest = (fenceHead_ - fenceCount_ + kMaxFramesInFlight) % kMaxFramesInFlight;
+        GLsync& f = fences_[(size_t)oldest];
+        GLenum r = glClientWaitSync(f, 0, 0);
+        if (r == GL_TIMEOUT_EXPIRED) {
+            ++fenceWaits_;
+            do {
+                r = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);   // 1ms
+            } while (r == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(f);
+        f = nullptr;
+        --fenceCount_;
+    }
+}
+
+void FramePacer::beginFrame() {
+    if (mode_ == PaceMode::Limiter) limit();
+    waitFramesInFlight();
+
+    const Clock::time_point now = Clock::now();
+    if (started_) {
+        frameMs_[(size_t)frameHead_] = std::chrono::duration<float, std::milli>(now - lastBegin_).count();
+        frameHead_ = (frameHead_ + 1) % kWindow;
+        frameCount_ = std::min(frameCount_ + 1, kWindow);
+    }
+    lastBegin_ = now;
+    started_ = true;
+}
+
+void FramePacer::endFrame() {
+    if (maxInFlight_ <= 0) return;
+    GLsync& f = fences_[(size_t)fenceHead_];
+    if (f) glDeleteSync(f);   // 不会发生（beginFrame 保证有空位），防御一下
+    f = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    fenceHead_ = (fenceHead_ + 1) % kMaxFramesInFlight;
+    fenceCount_ = std::min(fenceCount_ + 1, kMaxFramesInFlight);
+}
+
+FrameTimeStats FramePacer::stats() const {
+    FrameTimeStats s;
+    s.fenceWaits = fenceWaits_;
+    s.frames = frameCount_;
+    if (frameCount_ == 0) return s;
+
+    std::vector<float> sorted(frameMs_.begin(), frameMs_.begin() + frameCount_);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (float v : sorted) sum += v;
+    s.avgMs = sum / (double)sorted.size();
+    s.minMs = sorted.front();
+    s.p99Ms = sorted[std::min(sorted.size() - 1, (size_t)((double)sorted.size() * 0.99))];
+    s.maxMs = sorted.back();
+    s.fps = s.avgMs > 0.0 ? 1000.0 / s.avgMs : 0.0;
+    return s;
+}
@@ -0,0 +1,97 @@
+// ============================================================================
+// File: src/frame_pacer.hpp
+// 帧节奏：swap interval 模式 + 软件限帧 + “CPU 最多领先 GPU 几帧”。
+//   Vsync     swap interval 1
+//   Uncapped  swap interval 0，不限帧
+//   Adaptive  swap interval -1（掉帧时不等 vblank，避免直接掉到半帧率）；
+//             驱动不支持 *_swap_control_tear 时退回 Vsync
+//   Limiter   swap interval 0 + 睡眠/自旋混合，按目标 FPS 出帧
+// 每帧 swap 之后插一个 glFenceSync；下一帧开始前如果在途帧数已满，等最老的 fence，
+// 这样驱动不会把输入排到好几帧之后才显示。
+// ============================================================================
+#pragma once
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <GL/glew.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+enum class PaceMode {
+    Vsync,
+    Uncapped,
+    Adaptive,
+    Limiter,
+};
+
+// "vsync" / "uncapped" / "adaptive" / "limit"；不认识的返回 false
+bool parsePaceMode(const char* s, PaceMode& out);
+const char* paceModeName(PaceMode m);
+
+struct FramePacerConfig {
+    PaceMode mode = PaceMode::Vsync;
+    double targetFps = 120.0;     // 只有 Limiter 用
+    int maxFramesInFlight = 2;    // 1..kMaxFramesInFlight；0 = 不限制
+};
+
+struct FrameTimeStats {
+    int frames = 0;           // 窗口内帧数
+    double avgMs = 0.0;
+    double minMs = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double fps = 0.0;         // 1000 / avgMs
+    std::uint64_t fenceWaits = 0;   // 累计：因为在途帧满了而等 GPU 的次数
+};
+
+class FramePacer final {
+public:
+    static constexpr int kMaxFramesInFlight = 4;
+    static constexpr int kWindow = 240;
+
+    // GL context 必须已经 current（会设置 swap interval）
+    explicit FramePacer(const FramePacerConfig& cfg);
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // 帧开始（读输入之前）：限帧等待 + 在途帧数限制，并记录上一帧的帧时间
+    void beginFrame();
+    // glfwSwapBuffers 之后：插 fence
+    void endFrame();
+
+    // 实际生效的模式（Adaptive 可能退回 Vsync）
+    PaceMode mode() const { return mode_; }
+    std::string describe() const;
+    FrameTimeStats stats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    PaceMode mode_;
+    double targetFps_;
+    int maxInFlight_;
+
+    Clock::duration period_{};
+    Clock::time_point deadline_{};
+    Clock::time_point lastBegin_{};
+    bool started_ = false;
+
+    std::array<GLsync, kMaxFramesInFlight> fences_{};
+    int fenceHead_ = 0;      // 下一个写入位置
+    int fenceCount_ = 0;
+    std::uint64_t fenceWaits_ = 0;
+
+    std::array<float, kWindow> frameMs_{};
+    int frameHead_ = 0;
+    int frameCount_ = 0;
+
+    void limit();
+    void waitFramesInFlight();
+};
+
+#endif // FRAME_PACER_HPP
@@ -0,0 +1,51 @@
+// File: src/gpu_profiler.cpp
+#include "gpu_profiler.hpp"
+
+namespace {
+const char* const kPassNames[kGpuPassCount] = {
+    "gpu/mask", "gpu/objects", "gpu/wall", "gpu/composite", "gpu/ball",
+};
+} // namespace
+
+GpuProfiler::GpuProfiler() {
+    for (auto& frame : queries_) glGenQueries(kGpuPassCount, frame.data());
+    for (int p = 0; p < kGpuPassCount; ++p) {
+        sectionIds_[(size_t)p] = prof::Profiler::instance().section(kPassNames[p]);
+    }
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (auto& frame : queries_) glDeleteQueries(kGpuPassCount, frame.data());
+}
+
+void GpuProfiler::beginFrame() {
+    slot_ = (slot_ + 1) % kLatency;
+
+    for (int p = 0; p < kGpuPassCount; ++p) {
+        bool& pending = pending_[(size_t)slot_][(size_t)p];
+        if (!pending) continue;
+        pending = false;
+
+        const GLuint q = queries_[(size_t)slot_][(size_t)p];
+        GLint available = 0;
+        glGetQueryObjectiv(q, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;   // 丢样本也不等
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(q, GL_QUERY_RESULT, &ns);
+        prof::Profiler::instance().record(sectionIds_[(size_t)p], (double)ns * 1e-3);
+    }
+}
+
+void GpuProfiler::begin(GpuPass pass) {
+    if (open_ >= 0) end();
+    open_ = pass;
+    glBeginQuery(GL_TIME_ELAPSED, queries_[(size_t)slot_][(size_t)pass]);
+}
+
+void GpuProfiler::end() {
+    if (open_ < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    pending_[(size_t)slot_][(size_t)open_] = true;
+    open_ = -1;
+}
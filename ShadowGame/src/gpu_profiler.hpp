@@ -0,0 +1,71 @@
+// ============================================================================
+// File: src/gpu_profiler.hpp
+// 渲染 pass 的 GPU 耗时：每个 pass 一组 GL_TIME_ELAPSED query，按帧轮转 kLatency 组，
+// 晚 kLatency-1 帧再读（结果没好就丢掉这一帧的样本，绝不等 GPU）。
+// 读回的时间写进 prof::Profiler 的 "gpu/<pass>" 分段。
+// 和 SG_PROFILE_SCOPE 一样，只有 SHADOWGAME_PROFILE 时 SG_GPU_PASS 才展开。
+// ============================================================================
+#pragma once
+#ifndef GPU_PROFILER_HPP
+#define GPU_PROFILER_HPP
+
+#include <GL/glew.h>
+
+#include <array>
+
+#include "profiler.hpp"
+
+enum GpuPass : int {
+    kGpuPassMask = 0,     // PASS 0：阴影 mask
+    kGpuPassObjects,      // 盒子
+    kGpuPassWall,         // 墙底色
+    kGpuPassComposite,    // PASS 2：阴影合成（mask 或 stencil）
+    kGpuPassBall,
+    kGpuPassCount
+};
+
+class GpuProfiler final {
+public:
+    static constexpr int kLatency = 4;
+
+    GpuProfiler();
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // 每帧 render 开头：收 kLatency 帧前同一组 query 的结果，然后这一组给本帧用
+    void beginFrame();
+
+    // GL_TIME_ELAPSED 不能嵌套：同一时刻只能有一个 pass 在计时
+    void begin(GpuPass pass);
+    void end();
+
+private:
+    std::array<std::array<GLuint, kGpuPassCount>, kLatency> queries_{};
+    std::array<std::array<bool, kGpuPassCount>, kLatency> pending_{};
+    std::array<int, kGpuPassCount> sectionIds_{};
+    int slot_ = 0;
+    int open_ = -1;
+};
+
+class GpuPassScope final {
+public:
+    GpuPassScope(GpuProfiler& p, GpuPass pass) : p_(p) { p_.begin(pass); }
+    ~GpuPassScope() { p_.end(); }
+
+    GpuPassScope(const GpuPassScope&) = delete;
+    GpuPassScope& operator=(const GpuPassScope&) = delete;
+
+private:
+    GpuProfiler& p_;
+};
+
+#ifdef SHADOWGAME_PROFILE
+#define SG_GPU_PASS(profiler, pass) \
+    const GpuPassScope SG_PROFILE_CONCAT(sgGpuPass_, __LINE__)((profiler), (pass))
+#else
+#define SG_GPU_PASS(profiler, pass) ((void)0)
+#endif
+
+#endif // GPU_PROFILER_HPP
@@ -0,0 +1,288 @@
+// ==============================
+// File: headless_main.cpp
+// 无窗口批量运行：用脚本输入把关卡全速推进 N 个 tick，报告 steps/sec
+//   ShadowGame_headless --ticks 1000000 --tick-hz 120
+//   ShadowGame_headless --replay session.sgir      （按录制的输入跑，--ticks 不生效）
+//   ShadowGame_headless --ticks 5000 --record scripted.sgir
+//   ShadowGame_headless --gen 100000 --seed 3 --density 0.05   （程序化关卡，参数见 level_gen.hpp）
+//   ShadowGame_headless --profile --profile-csv sim.csv         （分段计时，需 -DSHADOWGAME_PROFILE=ON）
+//   “heap allocs” 一行统计稳态 tick（第一个 tick 之后）里 world.step 调用 operator new 的次数
+//   （-DSHADOWGAME_FRAME_ARENA=OFF 构建可以对比临时分配走全局堆时的数字）
+//   ShadowGame_headless --check-silhouettes                     （光源位置 × 盒子尺寸扫一遍，查表剪影 vs 参考凸包，不一致则退出码 1）
+//   ShadowGame_headless --gen 20000 --simd scalar               （批量角点投影强制走标量；state hash 应与 SIMD 一致）
+//   ShadowGame_headless --gen 20000 --jobs 7                    （hull 重建用 7 个工作线程；state hash 应与串行一致）
+// ==============================
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "input.hpp"
+#include "input_record.hpp"
+#include "job_system.hpp"
+#include "level_gen.hpp"
+#include "profiler.hpp"
+#include "shadow_simd.hpp"
+#include "world.hpp"
+
+// 计数用的全局 operator new：只数次数，分配本身还是 malloc / free
+static std::atomic<long long> g_heapAllocs{0};
+
+void* operator new(std::size_t n) {
+    g_heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return ::operator new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+// pmr::new_delete_resource 走的是带对齐的版本
+void* operator new(std::size_t n, std::align_val_t al) {
+    g_heapAllocs.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t a = (std::size_t)al;
+    if (void* p = std::aligned_alloc(a, (std::max<std::size_t>(n, 1) + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n, std::align_val_t al) { return ::operator new(n, al); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// 查表剪影（标量 + 各条 SIMD 批量投影路径）与 8 点投影 + 通用凸包逐个比对；返回不一致的个数
+static long long checkSilhouettes() {
+    const float extents[] = {0.05f, 0.5f, 1.0f, 2.5f, 6.0f};
+    const float lightXY[] = {-9.0f, -3.0f, -0.6f, -0.25f, 0.0f, 0.25f, 0.6f, 3.0f, 9.0f};
+    const float lightAbove[] = {0.01f, 0.5f, 3.0f, 20.0f};   // 光源 z 比盒子 zMax 高多少
+    const glm::vec3 center(0.3f, 2.0f, 5.0f);
+    const geom::SimdPath chosen = geom::activeSimdPath();
+
+    long long cases = 0, mismatches = 0;
+    auto check = [&](const char* path, const glm::vec3& light, const glm::vec3& bmin, const glm::vec3& bmax,
+                     const glm::vec2* out, int n) {
+        ++cases;
+        if (n >= 0 && ShadowWorld::silhouetteMatchesReference(light, bmin, bmax, out, n)) return;
+        if (mismatches < 10) {
+            std::fprintf(stderr, "silhouette mismatch (%s): light (%g, %g, %g) box (%g, %g, %g)-(%g, %g, %g)\n",
+                         path, light.x, light.y, light.z, bmin.x, bmin.y, bmin.z, bmax.x, bmax.y, bmax.z);
+        }
+        ++mismatches;
+    };
+
+    for (float ex : extents)
+    for (float ey : extents)
+    for (float ez : extents) {
+        const glm::vec3 half(0.5f * ex, 0.5f * ey, 0.5f * ez);
+        const glm::vec3 bmin = center - half;
+        const glm::vec3 bmax = center + half;
+
+        geom::BoxBatchSoA one;
+        one.count = 1;
+        one.cx[0] = center.x; one.cy[0] = center.y; one.cz[0] = center.z;
+        one.hx[0] = half.x;   one.hy[0] = half.y;   one.hz[0] = half.z;
+
+        for (float lx : lightXY)
+        for (float ly : lightXY)
+        for (float lz : lightAbove) {
+            // x / y 覆盖光源在盒子左 / 内 / 右（含贴着边界）的 27 个区域
+            const glm::vec3 light(center.x + lx * (0.5f + half.x), center.y + ly * (0.5f + half.y), bmax.z + lz);
+            glm::vec2 out[geom::kMaxSilhouetteVerts];
+
+            check("table", light, bmin, bmax, out, geom::boxSilhouetteOnWall(light, bmin, bmax, out));
+
+            // 批量投影的每条 SIMD 路径（一批一个盒子即可覆盖公式；多盒子的逐位一致性由 kernel 保证）
+            for (int p = 0; p <= (int)chosen; ++p) {
+                geom::setSimdPath((geom::SimdPath)p);
+                geom::ProjectedBatchSoA projected;
+                geom::projectBoxBatch(light, one, projected);
+                const int n = geom::silhouetteFromProjected(light, bmin, bmax, geom::projectedCorners(projected, 0), out);
+                check(geom::simdPathName((geom::SimdPath)p), light, bmin, bmax, out, n);
+            }
+        }
+    }
+    geom::setSimdPath(chosen);
+
+    std::printf("silhouettes  %lld cases, %lld mismatches\n", cases, mismatches);
+    return mismatches;
+}
+
+// 确定性的脚本输入：光源左右来回，球左右走、周期性起跳
+static InputState scriptedInput(long long tick, double tickHz) {
+    const double t = (double)tick / tickHz;
+
+    InputState in;
+    const double light = std::fmod(t, 4.0);
+    in.set(kInputLightRight, light < 2.0);
+    in.set(kInputLightLeft,  light >= 2.0);
+
+    const double walk = std::fmod(t, 3.0);
+    in.set(kInputRight, walk < 1.5);
+    in.set(kInputLeft,  walk >= 1.5);
+
+    in.set(kInputJump, std::fmod(t, 0.5) < 0.1);
+    return in;
+}
+
+int main(int argc, char** argv) {
+    long long ticks = 200000;
+    double tickHz = 120.0;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    LevelGenParams levelGen;
+    bool useGeneratedLevel = false;
+    bool printProfile = false;
+    bool checkOnly = false;
+    const char* profileCsv = nullptr;
+    int jobWorkers = 0;
+    geom::SimdPath simd = geom::detectSimdPath();
+    for (int i = 1; i < argc; ++i) {
+        if (parseLevelGenArg(argc, argv, i, levelGen, useGeneratedLevel)) continue;
+        if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = std::atoll(argv[++i]);
+        else if (!std::strcmp(argv[i], "--tick-hz") && i + 1 < argc) tickHz = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--record") && i + 1 < argc) recordPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--replay") && i + 1 < argc) replayPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--profile")) printProfile = true;
+        else if (!std::strcmp(argv[i], "--profile-csv") && i + 1 < argc) profileCsv = argv[++i];
+        else if (!std::strcmp(argv[i], "--jobs") && i + 1 < argc) jobWorkers = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--simd") && i + 1 < argc && geom::parseSimdPath(argv[i + 1], simd)) ++i;
+        else if (!std::strcmp(argv[i], "--check-silhouettes")) checkOnly = true;
+        else {
+            std::fprintf(stderr, "usage: %s [--ticks N] [--tick-hz HZ] [--record FILE | --replay FILE]\n"
+                                 "          [--profile] [--profile-csv FILE] [--jobs WORKERS] [--simd scalar|sse2|avx]\n"
+                                 "          [--check-silhouettes]\n"
+                                 "          [--gen N] [--seed S] [--density D] [--heights uniform|short|tall|bimodal] [--overlap F]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    if (checkOnly) {
+        geom::setSimdPath(simd);
+        return checkSilhouettes() == 0 ? 0 : 1;
+    }
+
+    std::unique_ptr<InputReplay> replay;
+    InputRecorder recorder;
+    try {
+        if (replayPath) {
+            replay = std::make_unique<InputReplay>(replayPath);
+            tickHz = replay->tickHz();
+        }
+        if (recordPath) recorder.open(recordPath, tickHz, 1);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Fatal: %s\n", e.what());
+        return 1;
+    }
+
+    if ((!replay && ticks < 1) || !(tickHz > 0.0)) {
+        std::fprintf(stderr, "--ticks and --tick-hz must be positive\n");
+        return 2;
+    }
+
+    geom::setSimdPath(simd);
+    JobSystem jobs(jobWorkers);
+    ShadowWorld world;
+    if (jobWorkers > 0) world.setJobSystem(&jobs);
+    if (useGeneratedLevel) {
+        GeneratedLevel level = generateLevel(levelGen);
+        world.loadLevel(std::move(level.objects), level.lightSpawn);
+    }
+    const float dt = (float)(1.0 / tickHz);
+
+    long long rebuilt = 0, reused = 0, silhouetteMismatches = 0;
+    long long steppedTicks = 0, steadyAllocs = 0;
+    auto stepOnce = [&](const InputState& in) {
+        const long long a0 = g_heapAllocs.load(std::memory_order_relaxed);
+        world.step(in, dt);
+        // 第一个 tick 会把各种缓冲开到位，不算
+        if (steppedTicks++ > 0) steadyAllocs += g_heapAllocs.load(std::memory_order_relaxed) - a0;
+        rebuilt += world.shadowStats().rebuilt;
+        silhouetteMismatches += world.shadowStats().silhouetteMismatches;
+        reused += world.shadowStats().reused;
+    };
+
+    const auto t0 = std::chrono::steady_clock::now();
+    if (replay) {
+        // 回放：只看录下来的 tick 输入，帧时间对模拟没有影响
+        ticks = 0;
+        double frameDt = 0.0;
+        std::vector<InputState> frame;
+        while (replay->nextFrame(frameDt, frame)) {
+            for (const InputState& in : frame) stepOnce(in);
+            ticks += (long long)frame.size();
+        }
+    } else {
+        for (long long tick = 0; tick < ticks; ++tick) {
+            const InputState in = scriptedInput(tick, tickHz);
+            stepOnce(in);
+            recorder.writeFrame(1.0 / tickHz, &in, 1);
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    recorder.close();
+
+    if (ticks < 1) {
+        std::fprintf(stderr, "replay contained no ticks\n");
+        return 1;
+    }
+
+    const double wall = std::chrono::duration<double>(t1 - t0).count();
+    const double stepsPerSec = wall > 0.0 ? (double)ticks / wall : 0.0;
+
+    std::printf("boxes        %d\n", (int)world.objects().size());
+    std::printf("simd         %s\n", geom::simdPathName(geom::activeSimdPath()));
+    std::printf("ticks        %lld (%.1f s simulated @ %.0f Hz)\n", ticks, (double)ticks / tickHz, tickHz);
+    std::printf("wall         %.3f s\n", wall);
+    std::printf("steps/sec    %.0f\n", stepsPerSec);
+    std::printf("us/step      %.3f\n", wall * 1e6 / (double)ticks);
+    std::printf("resets       %d\n", world.resetCount());
+    std::printf("hulls        rebuilt %lld, reused %lld\n", rebuilt, reused);
+    std::printf("heap allocs  %lld in %lld steady-state ticks (%.3f/tick)\n", steadyAllocs,
+                steppedTicks > 1 ? steppedTicks - 1 : 0,
+                steppedTicks > 1 ? (double)steadyAllocs / (double)(steppedTicks - 1) : 0.0);
+    std::printf("final ball   (%.3f, %.3f)%s\n", world.ball().pos.x, world.ball().pos.y,
+                world.ball().grounded() ? " grounded" : "");
+    std::printf("state hash   %016llx\n", (unsigned long long)world.stateHash());
+#ifdef SHADOWGAME_VALIDATE_SILHOUETTE
+    std::printf("silhouettes  %lld mismatches vs reference hull\n", silhouetteMismatches);
+#endif
+    if (jobWorkers > 0) {
+        // 每个 worker 分到的块 / 盒子数：看负载是否摊匀（worker 0 是主线程）
+        const std::vector<JobWorkerStats> ws = jobs.stats();
+        std::printf("jobs         %llu parallel rebuilds over %d workers\n",
+                    (unsigned long long)jobs.jobs(), jobs.concurrency());
+        for (size_t w = 0; w < ws.size(); ++w) {
+            std::printf("  worker %-3d %llu chunks, %llu boxes\n", (int)w,
+                        (unsigned long long)ws[w].chunks, (unsigned long long)ws[w].items);
+        }
+    }
+
+    if (printProfile || profileCsv) {
+#ifdef SHADOWGAME_PROFILE
+        std::fflush(stdout);
+        if (printProfile) prof::Profiler::instance().print(std::cout);
+        try {
+            if (profileCsv) prof::Profiler::instance().writeCsv(profileCsv);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s\n", e.what());
+            return 1;
+        }
+#else
+        std::fprintf(stderr, "profiling not compiled in (configure with -DSHADOWGAME_PROFILE=ON)\n");
+#endif
+    }
+    return silhouetteMismatches == 0 ? 0 : 1;
+}
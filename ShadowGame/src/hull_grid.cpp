@@ -0,0 +1,87 @@
+// ============================================================================
+// File: src/hull_grid.cpp
+// ============================================================================
+#include "hull_grid.hpp"
+
+#include <limits>
+
+// 容量不够时多留一半：光源一动格子数 / 条目数每 tick 都在小幅抖动，
+// 按刚好够的大小开会在稳态下反复重新分配
+static void reserveWithSlack(std::vector<int>& v, size_t n) {
+    if (v.capacity() < n) v.reserve(n + n / 2);
+}
+
+void HullGrid::build(const HullPool& pool) {
+    const int slots = pool.size();
+    slotCellX_.assign((size_t)slots, 0);
+    slotCellY_.assign((size_t)slots, 0);
+
+    // 场景范围 + 平均 hull 尺寸 -> 格子大小
+    float mnx = std::numeric_limits<float>::infinity();
+    float mny = std::numeric_limits<float>::infinity();
+    float mxx = -std::numeric_limits<float>::infinity();
+    float mxy = -std::numeric_limits<float>::infinity();
+    float extentSum = 0.0f;
+    int valid = 0;
+
+    for (int s = 0; s < slots; ++s) {
+        if (!pool.valid(s)) continue;
+        mnx = std::min(mnx, pool.minX(s));
+        mny = std::min(mny, pool.minY(s));
+        mxx = std::max(mxx, pool.maxX(s));
+        mxy = std::max(mxy, pool.maxY(s));
+        extentSum += std::max(pool.maxX(s) - pool.minX(s), pool.maxY(s) - pool.minY(s));
+        ++valid;
+    }
+
+    if (valid == 0) {
+        nx_ = ny_ = 0;
+        cellStart_.assign(1, 0);
+        items_.clear();
+        return;
+    }
+
+    const float w = std::max(mxx - mnx, 1e-3f);
+    const float h = std::max(mxy - mny, 1e-3f);
+
+    cellSize_ = std::max(extentSum / (float)valid, 1e-2f);
+
+    // 格子总数限制在 hull 数的常数倍内，避免稀疏大场景分配过多空格
+    const float maxCells = std::max(64.0f, 4.0f * (float)valid);
+    const float cells = std::ceil(w / cellSize_) * std::ceil(h / cellSize_);
+    if (cells > maxCells) cellSize_ *= std::sqrt(cells / maxCells);
+
+    invCell_ = 1.0f / cellSize_;
+    origin_ = glm::vec2(mnx, mny);
+    nx_ = std::max(1, (int)std::ceil(w * invCell_));
+    ny_ = std::max(1, (int)std::ceil(h * invCell_));
+
+    // pass 1：计数
+    reserveWithSlack(cellStart_, (size_t)nx_ * (size_t)ny_ + 1);
+    reserveWithSlack(cursor_, (size_t)nx_ * (size_t)ny_);
+    cellStart_.assign((size_t)nx_ * (size_t)ny_ + 1, 0);
+    for (int s = 0; s < slots; ++s) {
+        if (!pool.valid(s)) continue;
+        int x0, y0, x1, y1;
+        if (!cellRange(pool.minX(s), pool.minY(s), pool.maxX(s), pool.maxY(s), x0, y0, x1, y1)) continue;
+        slotCellX_[(size_t)s] = x0;
+        slotCellY_[(size_t)s] = y0;
+        for (int cy = y0; cy <= y1; ++cy)
+            for (int cx = x0; cx <= x1; ++cx)
+                ++cellStart_[(size_t)(cy * nx_ + cx) + 1];
+    }
+    for (size_t c = 1; c < cellStart_.size(); ++c) cellStart_[c] += cellStart_[c - 1];
+
+    // pass 2：填充（按槽位顺序写入，格内有序）
+    reserveWithSlack(items_, (size_t)cellStart_.back());
+    items_.assign((size_t)cellStart_.back(), -1);
+    cursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+    for (int s = 0; s < slots; ++s) {
+        if (!pool.valid(s)) continue;
+        int x0, y0, x1, y1;
+        if (!cellRange(pool.minX(s), pool.minY(s), pool.maxX(s), pool.maxY(s), x0, y0, x1, y1)) continue;
+        for (int cy = y0; cy <= y1; ++cy)
+            for (int cx = x0; cx <= x1; ++cx)
+                items_[(size_t)cursor_[(size_t)(cy * nx_ + cx)]++] = s;
+    }
+}
@@ -0,0 +1,78 @@
+// ============================================================================
+// File: src/hull_grid.hpp
+// 阴影平台的 broad phase：按 hull AABB 建均匀网格（CSR 存储），
+// 物理只测试查询框附近的 hull，而不是遍历全部平台。
+// ============================================================================
+#pragma once
+#ifndef HULL_GRID_HPP
+#define HULL_GRID_HPP
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "hull_pool.hpp"
+
+class HullGrid final {
+public:
+    // 跟着 rebuildShadowPlatforms 重建；只收录 valid 的槽位
+    void build(const HullPool& pool);
+
+    int cellsX() const { return nx_; }
+    int cellsY() const { return ny_; }
+    float cellSize() const { return cellSize_; }
+
+    // 对 AABB 与查询框所在格子重叠的每个槽位调用 visit(slot)，每个槽位最多一次
+    // （只在“槽位最小格与查询最小格的较大者”那一格上报，不需要去重表）
+    template <class F>
+    void query(float minX, float minY, float maxX, float maxY, F&& visit) const {
+        if (nx_ == 0 || ny_ == 0) return;
+
+        int qx0, qy0, qx1, qy1;
+        if (!cellRange(minX, minY, maxX, maxY, qx0, qy0, qx1, qy1)) return;
+
+        for (int cy = qy0; cy <= qy1; ++cy) {
+            for (int cx = qx0; cx <= qx1; ++cx) {
+                const int cell = cy * nx_ + cx;
+                for (int k = cellStart_[(size_t)cell]; k < cellStart_[(size_t)cell + 1]; ++k) {
+                    const int slot = items_[(size_t)k];
+                    const int sx0 = slotCellX_[(size_t)slot];
+                    const int sy0 = slotCellY_[(size_t)slot];
+                    if (cx != std::max(sx0, qx0) || cy != std::max(sy0, qy0)) continue;
+                    visit(slot);
+                }
+            }
+        }
+    }
+
+private:
+    float cellSize_ = 1.0f;
+    float invCell_ = 1.0f;
+    glm::vec2 origin_{0.0f};
+    int nx_ = 0, ny_ = 0;
+
+    std::vector<int> cellStart_;   // nx*ny + 1，CSR 偏移
+    std::vector<int> items_;       // 槽位号
+    std::vector<int> slotCellX_;   // 每个槽位 AABB 的最小格（用于去重）
+    std::vector<int> slotCellY_;
+    std::vector<int> cursor_;      // build 用的写指针，保留容量
+
+    // 查询框 -> 格子范围（夹到网格内）；完全在网格外返回 false
+    bool cellRange(float minX, float minY, float maxX, float maxY,
+                   int& x0, int& y0, int& x1, int& y1) const {
+        const float fx0 = std::floor((minX - origin_.x) * invCell_);
+        const float fy0 = std::floor((minY - origin_.y) * invCell_);
+        const float fx1 = std::floor((maxX - origin_.x) * invCell_);
+        const float fy1 = std::floor((maxY - origin_.y) * invCell_);
+        if (fx1 < 0.0f || fy1 < 0.0f || fx0 >= (float)nx_ || fy0 >= (float)ny_) return false;
+        x0 = std::max(0, (int)fx0);
+        y0 = std::max(0, (int)fy0);
+        x1 = std::min(nx_ - 1, (int)fx1);
+        y1 = std::min(ny_ - 1, (int)fy1);
+        return true;
+    }
+};
+
+#endif // HULL_GRID_HPP
@@ -0,0 +1,121 @@
+// ============================================================================
+// File: src/hull_pool.cpp
+// ============================================================================
+#include "hull_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void HullPool::reset(int slotCount) {
+    const size_t n = (size_t)std::max(0, slotCount);
+
+    objectId_.assign(n, -1);
+    count_.assign(n, 0);
+    verts_.assign(n * kStride, glm::vec2(0.0f));
+    normals_.assign(n * kStride, glm::vec2(0.0f));
+    edges_.assign(n * kEdgeFields * kStride, 0.0f);
+    wallMaskRising_.assign(n, 0u);
+    wallMaskFalling_.assign(n, 0u);
+
+    minX_.assign(n, 0.0f);
+    maxX_.assign(n, 0.0f);
+    minY_.assign(n, 0.0f);
+    maxY_.assign(n, 0.0f);
+    circleCenter_.assign(n, glm::vec2(0.0f));
+    circleRadius_.assign(n, 0.0f);
+
+    slotOf_.assign(n, -1);
+}
+
+void HullPool::setHull(int slot, int objectId, const glm::vec2* pts, int n) {
+    const size_t s = (size_t)slot;
+
+    if (objectId >= (int)slotOf_.size()) slotOf_.resize((size_t)objectId + 1, -1);
+    if (objectId_[s] >= 0 && objectId_[s] != objectId) slotOf_[(size_t)objectId_[s]] = -1;
+    objectId_[s] = objectId;
+    if (objectId >= 0) slotOf_[(size_t)objectId] = slot;
+
+    if (n < 3 || n > kStride) {
+        count_[s] = 0;   // 退化：保留槽位，消费者按 count<3 跳过
+        wallMaskRising_[s] = 0u;
+        wallMaskFalling_[s] = 0u;
+        return;
+    }
+    count_[s] = n;
+
+    glm::vec2* v = verts_.data() + s * kStride;
+    glm::vec2* nrm = normals_.data() + s * kStride;
+
+    float mnx = pts[0].x, mxx = pts[0].x;
+    float mny = pts[0].y, mxy = pts[0].y;
+    for (int i = 0; i < n; ++i) {
+        v[i] = pts[i];
+        mnx = std::min(mnx, pts[i].x);
+        mxx = std::max(mxx, pts[i].x);
+        mny = std::min(mny, pts[i].y);
+        mxy = std::max(mxy, pts[i].y);
+    }
+
+    // CCW 外法线 = 边的右法线；退化边给 (0,1)，与 normalizeSafe 的约定一致
+    // 顺便打包边：多出来的 lane 清零、不进 mask，kernel 整组 8 个加载也不会误判
+    float* ed = edges_.data() + s * kEdgeFields * kStride;
+    unsigned rising = 0u, falling = 0u;
+    for (int i = 0; i < kStride; ++i) {
+        if (i >= n) {
+            for (int f = 0; f < kEdgeFields; ++f) ed[f * kStride + i] = 0.0f;
+            continue;
+        }
+        const glm::vec2 e = v[(i + 1) % n] - v[i];
+        const float l2 = e.x * e.x + e.y * e.y;
+        const bool degenerate = l2 < 1e-10f;
+        nrm[i] = degenerate ? glm::vec2(0.0f, 1.0f) : glm::vec2(e.y, -e.x) * (1.0f / std::sqrt(l2));
+
+        ed[kEdgeAx * kStride + i] = v[i].x;
+        ed[kEdgeAy * kStride + i] = v[i].y;
+        ed[kEdgeEx * kStride + i] = e.x;
+        ed[kEdgeEy * kStride + i] = e.y;
+        ed[kEdgeInvLen2 * kStride + i] = degenerate ? 0.0f : 1.0f / l2;
+
+        if (degenerate) continue;
+        const bool side = std::fabs(nrm[i].x) > 0.6f;
+        const bool ceil = nrm[i].y < -0.6f;   // CCW 外法线朝下 = 天花板
+        if (side || ceil) rising |= 1u << i;
+        if (side && !ceil) falling |= 1u << i;
+    }
+    wallMaskRising_[s] = rising;
+    wallMaskFalling_[s] = falling;
+
+    // 包围圆：取 AABB 中心，半径覆盖所有顶点（不求最小圆，够做粗筛）
+    const glm::vec2 c(0.5f * (mnx + mxx), 0.5f * (mny + mxy));
+    float r2 = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        const glm::vec2 d = v[i] - c;
+        r2 = std::max(r2, d.x * d.x + d.y * d.y);
+    }
+
+    minX_[s] = mnx;
+    maxX_[s] = mxx;
+    minY_[s] = mny;
+    maxY_[s] = mxy;
+    circleCenter_[s] = c;
+    circleRadius_[s] = std::sqrt(r2);
+}
+
+HullView HullPool::view(int slot) const {
+    const size_t s = (size_t)slot;
+    HullView h;
+    h.verts = verts(slot);
+    h.normals = normals(slot);
+    h.edges = edges(slot);
+    h.wallMaskRising = wallMaskRising_[s];
+    h.wallMaskFalling = wallMaskFalling_[s];
+    h.count = count_[s];
+    h.objectId = objectId_[s];
+    h.minX = minX_[s];
+    h.maxX = maxX_[s];
+    h.minY = minY_[s];
+    h.maxY = maxY_[s];
+    h.center = circleCenter_[s];
+    h.radius = circleRadius_[s];
+    return h;
+}
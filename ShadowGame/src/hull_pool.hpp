@@ -0,0 +1,104 @@
+// ============================================================================
+// File: src/hull_pool.hpp
+// 阴影平台的扁平存储（SoA）：所有 hull 顶点放在一块连续数组里，
+// 每个槽位的 AABB / 包围圆 / 单位外法线 / 打包的边在重建时算一次，物理直接读。
+// ============================================================================
+#pragma once
+#ifndef HULL_POOL_HPP
+#define HULL_POOL_HPP
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// 打包边（SoA）：每个槽位 kEdgeFields 组、每组 HullPool::kStride 个 float，
+// 第 f 组第 i 个 = 边 i（verts[i] -> verts[i+1]）的字段 f。给圆-边穿透的 SIMD kernel 整组加载
+enum HullEdgeField {
+    kEdgeAx = 0, kEdgeAy,     // 起点
+    kEdgeEx, kEdgeEy,         // 方向 verts[i+1] - verts[i]
+    kEdgeInvLen2,             // 1 / |e|^2（退化边为 0，且不会出现在任何 mask 里）
+    kEdgeFields
+};
+
+// 单个 hull 的只读视图（指针指向 HullPool 内部，下一次重建前有效）
+struct HullView {
+    const glm::vec2* verts = nullptr;    // CCW
+    const glm::vec2* normals = nullptr;  // normals[i]：边 verts[i] -> verts[i+1] 的单位外法线
+    const float* edges = nullptr;        // kEdgeFields * kStride，见 HullEdgeField
+    int count = 0;
+    int objectId = -1;
+
+    // 会挡球的边（bit i = 边 i）：side = |n.x| > 0.6，ceiling = n.y < -0.6，
+    // ceiling 只在球往上走时才挡 —— rising 给 vel.y > 0 用，falling 给其余情况
+    unsigned wallMaskRising = 0;
+    unsigned wallMaskFalling = 0;
+
+    float minX = 0.0f, maxX = 0.0f;
+    float minY = 0.0f, maxY = 0.0f;
+    glm::vec2 center{0.0f};              // 包围圆
+    float radius = 0.0f;
+
+    bool valid() const { return count >= 3; }
+};
+
+// 只有顶点的视图：槽位 s 的顶点在 verts[s * HullPool::kStride] 起，counts[s] 个（<3 为退化）
+// CPU 阴影 mesh 只读这两样
+struct HullVertsView {
+    const glm::vec2* verts = nullptr;
+    const int* counts = nullptr;
+    int size = 0;
+};
+
+class HullPool final {
+public:
+    // 每个槽位固定预留的顶点数：剪影最多 6，通用凸包（8 个角点）最多 8
+    static constexpr int kStride = 8;
+
+    // 重新分配 slotCount 个空槽（objectId -> slot 表一起清空）
+    void reset(int slotCount);
+
+    int size() const { return (int)count_.size(); }
+
+    // 写入 slot 的 hull（n<3 视为退化，槽位保留但 count=0），并计算派生数据
+    void setHull(int slot, int objectId, const glm::vec2* pts, int n);
+
+    // O(1)：objectId -> slot，没有则 -1
+    int slotOf(int objectId) const {
+        return (objectId >= 0 && objectId < (int)slotOf_.size()) ? slotOf_[(size_t)objectId] : -1;
+    }
+
+    int count(int slot) const { return count_[(size_t)slot]; }
+    int objectId(int slot) const { return objectId_[(size_t)slot]; }
+    bool valid(int slot) const { return count_[(size_t)slot] >= 3; }
+
+    const glm::vec2* verts(int slot) const { return verts_.data() + (size_t)slot * kStride; }
+    const glm::vec2* normals(int slot) const { return normals_.data() + (size_t)slot * kStride; }
+    const float* edges(int slot) const { return edges_.data() + (size_t)slot * kEdgeFields * kStride; }
+
+    float minX(int slot) const { return minX_[(size_t)slot]; }
+    float maxX(int slot) const { return maxX_[(size_t)slot]; }
+    float minY(int slot) const { return minY_[(size_t)slot]; }
+    float maxY(int slot) const { return maxY_[(size_t)slot]; }
+    const glm::vec2& circleCenter(int slot) const { return circleCenter_[(size_t)slot]; }
+    float circleRadius(int slot) const { return circleRadius_[(size_t)slot]; }
+
+    HullView view(int slot) const;
+    HullVertsView vertsView() const { return HullVertsView{verts_.data(), count_.data(), size()}; }
+
+private:
+    std::vector<int> objectId_;
+    std::vector<int> count_;
+
+    std::vector<glm::vec2> verts_;     // size() * kStride
+    std::vector<glm::vec2> normals_;   // size() * kStride
+    std::vector<float> edges_;         // size() * kEdgeFields * kStride
+    std::vector<unsigned> wallMaskRising_, wallMaskFalling_;
+
+    std::vector<float> minX_, maxX_, minY_, maxY_;
+    std::vector<glm::vec2> circleCenter_;
+    std::vector<float> circleRadius_;
+
+    std::vector<int> slotOf_;          // dense：下标是 objectId
+};
+
+#endif // HULL_POOL_HPP
@@ -0,0 +1,30 @@
+// ============================================================================
+// File: src/input.hpp
+// 一个 tick 的输入快照：模拟层只认这个，不直接读 GLFW（窗口端采样后传进来）
+// ============================================================================
+#pragma once
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <cstdint>
+
+enum InputBit : std::uint16_t {
+    kInputLeft       = 1u << 0,   // A
+    kInputRight      = 1u << 1,   // D
+    kInputJump       = 1u << 2,   // W / Space（按住即为 1，边沿由 ShadowBall 自己判断）
+    kInputLightLeft  = 1u << 3,   // ←
+    kInputLightRight = 1u << 4,   // →
+    kInputLightUp    = 1u << 5,   // ↑
+    kInputLightDown  = 1u << 6,   // ↓
+    kInputFovNarrow  = 1u << 7,   // Q
+    kInputFovWiden   = 1u << 8,   // E
+};
+
+struct InputState {
+    std::uint16_t bits = 0;
+
+    bool held(InputBit b) const { return (bits & b) != 0; }
+    void set(InputBit b, bool on) { bits = on ? std::uint16_t(bits | b) : std::uint16_t(bits & ~b); }
+};
+
+#endif // INPUT_HPP
@@ -0,0 +1,137 @@
+// ============================================================================
+// File: src/input_record.cpp
+// ============================================================================
+#include "input_record.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'G', 'I', 'R'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderBytes = 4 + 4 + 8 + 4;
+
+// 固定小端，跟机器字节序无关
+void putU16(std::vector<std::uint8_t>& b, std::uint16_t v) {
+    b.push_back((std::uint8_t)(v & 0xFF));
+    b.push_back((std::uint8_t)(v >> 8));
+}
+
+void putU32(std::vector<std::uint8_t>& b, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) b.push_back((std::uint8_t)(v >> (8 * i)));
+}
+
+void putF64(std::vector<std::uint8_t>& b, double d) {
+    std::uint64_t v = 0;
+    std::memcpy(&v, &d, sizeof(v));
+    for (int i = 0; i < 8; ++i) b.push_back((std::uint8_t)(v >> (8 * i)));
+}
+
+std::uint16_t getU16(const std::uint8_t* p) {
+    return (std::uint16_t)(p[0] | (p[1] << 8));
+}
+
+std::uint32_t getU32(const std::uint8_t* p) {
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= (std::uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+double getF64(const std::uint8_t* p) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= (std::uint64_t)p[i] << (8 * i);
+    double d = 0.0;
+    std::memcpy(&d, &v, sizeof(d));
+    return d;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// InputRecorder
+// ---------------------------------------------------------------------------
+void InputRecorder::open(const std::string& path, double tickHz, int maxStepsPerFrame) {
+    close();
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) throw std::runtime_error("Failed to open input record file: " + path);
+
+    buf_.clear();
+    buf_.reserve(kFlushBytes + 256);
+    frames_ = 0;
+
+    buf_.insert(buf_.end(), kMagic, kMagic + 4);
+    putU32(buf_, kVersion);
+    putF64(buf_, tickHz);
+    putU32(buf_, (std::uint32_t)maxStepsPerFrame);
+}
+
+void InputRecorder::close() {
+    if (!file_) return;
+    flush();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void InputRecorder::writeFrame(double frameDt, const InputState* ticks, int steps) {
+    if (!file_) return;
+
+    putF64(buf_, frameDt);
+    putU16(buf_, (std::uint16_t)steps);
+    for (int i = 0; i < steps; ++i) putU16(buf_, ticks[i].bits);
+    ++frames_;
+
+    if (buf_.size() >= kFlushBytes) flush();
+}
+
+void InputRecorder::flush() {
+    if (!file_ || buf_.empty()) return;
+    std::fwrite(buf_.data(), 1, buf_.size(), file_);
+    buf_.clear();
+}
+
+// ---------------------------------------------------------------------------
+// InputReplay
+// ---------------------------------------------------------------------------
+InputReplay::InputReplay(const std::string& path) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) throw std::runtime_error("Failed to open input replay file: " + path);
+
+    std::uint8_t chunk[64 * 1024];
+    std::size_t n = 0;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) data_.insert(data_.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    if (data_.size() < kHeaderBytes || std::memcmp(data_.data(), kMagic, 4) != 0)
+        throw std::runtime_error("Not an input record file: " + path);
+    if (getU32(data_.data() + 4) != kVersion)
+        throw std::runtime_error("Unsupported input record version: " + path);
+
+    tickHz_ = getF64(data_.data() + 8);
+    maxSteps_ = (int)getU32(data_.data() + 16);
+    pos_ = kHeaderBytes;
+
+    if (!(tickHz_ > 0.0)) throw std::runtime_error("Bad tick rate in input record file: " + path);
+}
+
+bool InputReplay::nextFrame(double& frameDt, std::vector<InputState>& ticks) {
+    if (data_.size() - pos_ < 10) {
+        pos_ = data_.size();   // 截断的尾巴（录制中途崩溃）直接当结束
+        return false;
+    }
+
+    const std::uint8_t* p = data_.data() + pos_;
+    const double dt = getF64(p);
+    const int steps = getU16(p + 8);
+    if (data_.size() - pos_ - 10 < (std::size_t)steps * 2) {
+        pos_ = data_.size();
+        return false;
+    }
+
+    frameDt = dt;
+    ticks.resize((std::size_t)steps);
+    for (int i = 0; i < steps; ++i) ticks[(std::size_t)i].bits = getU16(p + 10 + 2 * i);
+    pos_ += 10 + (std::size_t)steps * 2;
+    return true;
+}
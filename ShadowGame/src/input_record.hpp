@@ -0,0 +1,69 @@
+// ============================================================================
+// File: src/input_record.hpp
+// 输入录制 / 回放：每帧记录真实 frameDt + 本帧各 tick 的 InputState 位掩码，
+// 回放时按原样喂回 step()，模拟结果逐位一致。
+//
+// 文件格式（小端）：
+//   header : "SGIR" | u32 version | f64 tickHz | u32 maxStepsPerFrame
+//   frame  : f64 frameDt | u16 steps | steps × u16 bits
+// 常见一帧 1 tick = 12 字节；写入先进内存缓冲，攒满再 fwrite，正式版也可以常开。
+// ============================================================================
+#pragma once
+#ifndef INPUT_RECORD_HPP
+#define INPUT_RECORD_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "input.hpp"
+
+class InputRecorder final {
+public:
+    InputRecorder() = default;
+    ~InputRecorder() { close(); }
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    // 打不开文件抛 std::runtime_error
+    void open(const std::string& path, double tickHz, int maxStepsPerFrame);
+    void close();
+    bool isOpen() const { return file_ != nullptr; }
+
+    // 一帧：真实 dt + 本帧推进的每个 tick 的输入
+    void writeFrame(double frameDt, const InputState* ticks, int steps);
+
+    std::uint64_t framesWritten() const { return frames_; }
+
+private:
+    static constexpr std::size_t kFlushBytes = 64 * 1024;
+
+    std::FILE* file_ = nullptr;
+    std::vector<std::uint8_t> buf_;
+    std::uint64_t frames_ = 0;
+
+    void flush();
+};
+
+class InputReplay final {
+public:
+    // 整个文件读进内存；打不开 / 格式不对抛 std::runtime_error
+    explicit InputReplay(const std::string& path);
+
+    double tickHz() const { return tickHz_; }
+    int maxStepsPerFrame() const { return maxSteps_; }
+
+    // 读下一帧；文件读完返回 false。ticks 会被 resize 成本帧的 tick 数
+    bool nextFrame(double& frameDt, std::vector<InputState>& ticks);
+    bool finished() const { return pos_ >= data_.size(); }
+
+private:
+    std::vector<std::uint8_t> data_;
+    std::size_t pos_ = 0;
+    double tickHz_ = 120.0;
+    int maxSteps_ = 8;
+};
+
+#endif // INPUT_RECORD_HPP
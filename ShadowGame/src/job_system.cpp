@@ -0,0 +1,100 @@
+// File: src/job_system.cpp
+#include "job_system.hpp"
+
+#include <algorithm>
+
+JobSystem::JobSystem(int workers) {
+    const int n = std::max(0, workers);
+    slots_.resize((size_t)n + 1);
+    threads_.reserve((size_t)n);
+    for (int w = 1; w <= n; ++w) threads_.emplace_back(&JobSystem::workerLoop, this, w);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& t : threads_) t.join();
+}
+
+int JobSystem::defaultWorkerCount() {
+    const unsigned hw = std::thread::hardware_concurrency();   // 未知时返回 0
+    return hw > 1 ? (int)hw - 1 : 0;
+}
+
+std::vector<JobWorkerStats> JobSystem::stats() const {
+    std::vector<JobWorkerStats> out;
+    out.reserve(slots_.size());
+    for (const WorkerSlot& s : slots_) out.push_back(s.stats);
+    return out;
+}
+
+void JobSystem::resetStats() {
+    for (WorkerSlot& s : slots_) s.stats = JobWorkerStats{};
+    jobs_ = 0;
+}
+
+void JobSystem::run(int count, int grain, RangeFn fn, void* ctx) {
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    const int chunks = (count + grain - 1) / grain;
+    ++jobs_;
+
+    if (threads_.empty() || chunks == 1) {
+        fn(ctx, 0, count, 0);
+        slots_[0].stats.chunks += 1;
+        slots_[0].stats.items += (std::uint64_t)count;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        fn_ = fn;
+        ctx_ = ctx;
+        count_ = count;
+        grain_ = grain;
+        chunkCount_ = chunks;
+        nextChunk_.store(0, std::memory_order_relaxed);
+        busy_ = (int)threads_.size();
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);
+
+    // 块都被领走了不代表做完了：等所有工作线程报到
+    std::unique_lock<std::mutex> lock(mu_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+}
+
+void JobSystem::drain(int worker) {
+    JobWorkerStats& st = slots_[(size_t)worker].stats;
+    for (;;) {
+        const int c = nextChunk_.fetch_add(1, std::memory_order_relaxed);
+        if (c >= chunkCount_) break;
+        const int begin = c * grain_;
+        const int end = std::min(count_, begin + grain_);
+        fn_(ctx_, begin, end, worker);
+        st.chunks += 1;
+        st.items += (std::uint64_t)(end - begin);
+    }
+}
+
+void JobSystem::workerLoop(int worker) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mu_);
+            wake_.wait(lock, [&] { return quit_ || generation_ != seen; });
+            if (quit_) return;
+            seen = generation_;
+        }
+
+        drain(worker);
+
+        std::lock_guard<std::mutex> lock(mu_);
+        if (--busy_ == 0) done_.notify_one();
+    }
+}
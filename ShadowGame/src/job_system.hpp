@@ -0,0 +1,90 @@
+// ============================================================================
+// File: src/job_system.hpp
+// 常驻工作线程 + parallelFor：把 [0, count) 切成 grain 大小的块，工作线程和调用线程一起抢块做，
+// 全部做完才返回。块的分配是动态的（谁先空谁拿），所以回调只能写“按下标划分”的输出，
+// 或者写 worker 号对应的私有缓冲，调用方返回后再按 worker 顺序合并——这样结果与线程调度无关。
+//
+// 同一时刻只允许一个线程调用 parallelFor（目前只有模拟线程在用）；回调不能抛异常。
+// 不依赖 GL，属于 ShadowCore。
+// ============================================================================
+#pragma once
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// 每个 worker 的累计工作量（worker 0 是调用 parallelFor 的线程）
+struct JobWorkerStats {
+    std::uint64_t chunks = 0;
+    std::uint64_t items = 0;
+};
+
+class JobSystem final {
+public:
+    // workers：额外开的线程数，0 = 全部在调用线程上串行跑
+    explicit JobSystem(int workers);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 核数 - 1（调用线程自己也算一个），至少 0
+    static int defaultWorkerCount();
+
+    // 并行度 = 工作线程 + 调用线程；per-worker 缓冲按这个数开
+    int concurrency() const { return (int)threads_.size() + 1; }
+
+    // fn(begin, end, worker)：worker ∈ [0, concurrency())
+    // 只有一个块（或没有工作线程）时直接在调用线程上跑，不唤醒任何人
+    template <class F>
+    void parallelFor(int count, int grain, F&& fn) {
+        using Fn = std::remove_reference_t<F>;
+        run(count, grain,
+            [](void* ctx, int begin, int end, int worker) { (*static_cast<Fn*>(ctx))(begin, end, worker); },
+            const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+    // 只能在没有 parallelFor 进行中时调用
+    std::vector<JobWorkerStats> stats() const;
+    std::uint64_t jobs() const { return jobs_; }
+    void resetStats();
+
+private:
+    using RangeFn = void (*)(void* ctx, int begin, int end, int worker);
+
+    // 每个 worker 只写自己那一格；按 cache line 对齐，避免伪共享
+    struct alignas(64) WorkerSlot {
+        JobWorkerStats stats;
+    };
+
+    std::vector<std::thread> threads_;
+    std::vector<WorkerSlot> slots_;
+    std::uint64_t jobs_ = 0;
+
+    // 当前任务：只在 mu_ 下、且上一轮全部结束后才改
+    std::mutex mu_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::uint64_t generation_ = 0;
+    bool quit_ = false;
+    int busy_ = 0;                    // 还没做完本轮的工作线程数
+    RangeFn fn_ = nullptr;
+    void* ctx_ = nullptr;
+    int count_ = 0;
+    int grain_ = 1;
+    int chunkCount_ = 0;
+    std::atomic<int> nextChunk_{0};
+
+    void run(int count, int grain, RangeFn fn, void* ctx);
+    void drain(int worker);
+    void workerLoop(int worker);
+};
+
+#endif // JOB_SYSTEM_HPP
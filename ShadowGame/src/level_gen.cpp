@@ -0,0 +1,132 @@
+// ============================================================================
+// File: src/level_gen.cpp
+// 布局：抖动网格。cols × rows 个格子（宽高比约 4:1），格子边长由 density 决定。
+//   第 0 行：立在地面上的塔；其余行：悬空的台子 / 木板
+// 盒子 z 在 [4, 8] 附近，光源出生点放在最左边几列上方、比所有盒子都靠前。
+// ============================================================================
+#include "level_gen.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// splitmix64：状态一个 u64，输出质量够用，跨平台结果一致
+struct SplitMix64 {
+    std::uint64_t state;
+
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1)，24 位尾数，float 精确
+    float unit() { return (float)(next() >> 40) * (1.0f / 16777216.0f); }
+    float range(float a, float b) { return a + (b - a) * unit(); }
+};
+
+float sampleHeight(SplitMix64& rng, const LevelGenParams& p) {
+    const float u = rng.unit();
+    float f = u;
+    switch (p.heights) {
+    case HeightDist::Uniform: f = u; break;
+    case HeightDist::Short:   f = u * u; break;
+    case HeightDist::Tall:    f = std::sqrt(u); break;
+    case HeightDist::Bimodal: f = (u < 0.5f) ? u * 0.4f : 0.8f + (u - 0.5f) * 0.4f; break;
+    }
+    return p.minHeight + (p.maxHeight - p.minHeight) * f;
+}
+
+glm::vec3 cardboard(float t) {
+    return glm::vec3(0.72f + 0.05f * t, 0.60f + 0.04f * t, 0.42f + 0.02f * t);
+}
+
+} // namespace
+
+GeneratedLevel generateLevel(const LevelGenParams& params) {
+    GeneratedLevel out;
+
+    const int count = std::max(1, params.count);
+    const float density = std::max(params.density, 1e-4f);
+    const float overlap = std::clamp(params.overlap, 0.0f, 1.0f);
+
+    const float cell = std::sqrt(1.0f / density);
+    const int rows = std::max(1, (int)std::lround(std::sqrt((double)count / 4.0)));
+    const int cols = (count + rows - 1) / rows;
+    const float x0 = -10.0f;
+
+    SplitMix64 rng(params.seed);
+    out.objects.reserve((size_t)count);
+
+    float maxZ = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        const int c = i % cols;
+        const int r = i / cols;
+
+        // 宽：格子的 25%~75%，overlap 允许再伸出去
+        const float spill = 1.0f + 2.0f * overlap;
+        const float w = cell * rng.range(0.25f, 0.75f) * spill;
+        const float d = rng.range(1.0f, 4.0f);
+
+        float h = sampleHeight(rng, params);
+        if (r > 0) h = std::min(h, cell * 0.35f);              // 悬空行是台子，不是塔
+        h = std::min(h, cell * (0.9f + 2.0f * overlap));         // overlap=0：不伸进上一行
+
+        // 格内抖动：overlap=0 时保证整块在格子里
+        const float slackX = std::max(0.0f, cell - w) * 0.5f + cell * overlap;
+        const float cx = x0 + ((float)c + 0.5f) * cell + rng.range(-slackX, slackX);
+
+        float baseY = 0.0f;
+        if (r > 0) {
+            const float slackY = std::max(0.0f, cell * 0.9f - h);
+            baseY = (float)r * cell + rng.range(0.0f, slackY + cell * overlap);
+        }
+
+        const float cz = rng.range(4.0f, 8.0f);
+        maxZ = std::max(maxZ, cz + 0.5f * d);
+
+        const glm::vec3 col = (r > 0 && w > 2.0f * h) ? glm::vec3(0.46f, 0.30f, 0.18f)   // 扁的当木板
+                                                       : cardboard(rng.range(-0.15f, 0.15f));
+        out.objects.emplace_back(glm::vec3(cx, baseY + 0.5f * h, cz), glm::vec3(w, h, d), col);
+    }
+
+    // 光源：最左两格上方，z 比所有盒子都靠前（阴影走查表剪影快速路径）
+    out.lightSpawn = glm::vec3(x0 + 1.5f * cell,
+                               std::min(10.0f, std::max(params.maxHeight, 2.0f) * 0.8f),
+                               maxZ + 4.0f);
+    return out;
+}
+
+bool parseLevelGenArg(int argc, char** argv, int& i, LevelGenParams& params, bool& outRequested) {
+    const char* a = argv[i];
+    if (i + 1 >= argc) return false;
+    const char* v = argv[i + 1];
+
+    if (!std::strcmp(a, "--gen")) {
+        params.count = std::max(1, std::atoi(v));
+        outRequested = true;
+    } else if (!std::strcmp(a, "--seed")) {
+        params.seed = std::strtoull(v, nullptr, 10);
+    } else if (!std::strcmp(a, "--density")) {
+        params.density = (float)std::atof(v);
+    } else if (!std::strcmp(a, "--overlap")) {
+        params.overlap = (float)std::atof(v);
+    } else if (!std::strcmp(a, "--heights")) {
+        if      (!std::strcmp(v, "uniform")) params.heights = HeightDist::Uniform;
+        else if (!std::strcmp(v, "short"))   params.heights = HeightDist::Short;
+        else if (!std::strcmp(v, "tall"))    params.heights = HeightDist::Tall;
+        else if (!std::strcmp(v, "bimodal")) params.heights = HeightDist::Bimodal;
+        else return false;
+    } else {
+        return false;
+    }
+
+    ++i;
+    return true;
+}
@@ -0,0 +1,50 @@
+// ============================================================================
+// File: src/level_gen.hpp
+// 程序化关卡：按种子生成 N 个盒子（几十 ~ 十万），用来测阴影重建 / 碰撞 / 渲染随规模的变化。
+// 同一组参数在任何机器上生成完全相同的关卡（自带 RNG，不用 <random> 的分布）。
+// ============================================================================
+#pragma once
+#ifndef LEVEL_GEN_HPP
+#define LEVEL_GEN_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "box.hpp"
+
+enum class HeightDist {
+    Uniform,   // [minHeight, maxHeight] 均匀
+    Short,     // 偏矮：大量低台子
+    Tall,      // 偏高：大量高塔
+    Bimodal,   // 一半矮一半高
+};
+
+struct LevelGenParams {
+    std::uint64_t seed = 1;
+    int count = 64;
+
+    // 墙面上每平方单位的盒子数（默认关卡约 0.02）；越大越挤
+    float density = 0.02f;
+
+    float minHeight = 0.5f;
+    float maxHeight = 12.0f;
+    HeightDist heights = HeightDist::Uniform;
+
+    // 0：每个盒子留在自己的格子里，互不重叠；1：宽/高可以伸进相邻格子一整格
+    float overlap = 0.0f;
+};
+
+struct GeneratedLevel {
+    std::vector<BoxObject> objects;
+    glm::vec3 lightSpawn{0.0f};
+};
+
+GeneratedLevel generateLevel(const LevelGenParams& params);
+
+// 命令行：--gen N --seed S --density D --heights uniform|short|tall|bimodal --overlap F
+// argv[i] 是关卡参数时吃掉它（及其值）、推进 i 并返回 true；--gen 出现过则 outRequested = true
+bool parseLevelGenArg(int argc, char** argv, int& i, LevelGenParams& params, bool& outRequested);
+
+#endif // LEVEL_GEN_HPP
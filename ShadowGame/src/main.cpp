@@ -1,13 +1,26 @@
 // ==============================
 // File: main.cpp
 // ==============================
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include "fixed_step.hpp"
+#include "frame_pacer.hpp"
+#include "input.hpp"
+#include "input_record.hpp"
+#include "job_system.hpp"
+#include "level_gen.hpp"
+#include "profiler.hpp"
 #include "scene.hpp"
+#include "sim_thread.hpp"
 
 static void glfwErrorCallback(int code, const char* desc) {
     std::cerr << "[GLFW] Error " << code << ": " << (desc ? desc : "") << "\n";
@@ -19,13 +32,110 @@ static void framebufferSizeCallback(GLFWwindow* window, int w, int h) {
     if (scene) scene->onResize(w, h);
 }
 
-int main() {
+// 键盘 -> InputState：模拟层只看这个
+static InputState pollInput(GLFWwindow* window) {
+    auto down = [window](int key) { return glfwGetKey(window, key) == GLFW_PRESS; };
+
+    InputState in;
+    in.set(kInputLeft,       down(GLFW_KEY_A));
+    in.set(kInputRight,      down(GLFW_KEY_D));
+    in.set(kInputJump,       down(GLFW_KEY_W) || down(GLFW_KEY_SPACE));
+    in.set(kInputLightLeft,  down(GLFW_KEY_LEFT));
+    in.set(kInputLightRight, down(GLFW_KEY_RIGHT));
+    in.set(kInputLightUp,    down(GLFW_KEY_UP));
+    in.set(kInputLightDown,  down(GLFW_KEY_DOWN));
+    in.set(kInputFovNarrow,  down(GLFW_KEY_Q));
+    in.set(kInputFovWiden,   down(GLFW_KEY_E));
+    return in;
+}
+
+int main(int argc, char** argv) {
+    // 模拟频率与渲染解耦：--tick-hz 120 --max-steps 8
+    // 录制 / 回放输入：--record session.sgir / --replay session.sgir
+    // 程序化关卡：--gen 5000 --seed 7 --density 0.05 --heights tall --overlap 0.3
+    //   （回放生成关卡的录像时要带上同样的 --gen 参数）
+    // --cpu-shadow-mesh：阴影 mask 用 CPU 凸包三角化（默认是 GPU 投影）；运行时 M 键切换
+    // --mask-scale 2|4：阴影 mask 降到 1/2、1/4 分辨率；--mask-upsample bilinear|edge（默认 edge）
+    // --shadow-composite mask|stencil：阴影合成方式；运行时 N 键切换
+    // --composite-ab：关掉 vsync，两种合成方式每 2 秒轮换一次并打印平均帧时间
+    // --no-shadow-scissor：阴影 pass 不裁到光圈矩形（对比用）
+    // --profile：每 2 秒打印分段计时；--profile-csv FILE：退出时写 CSV（需 -DSHADOWGAME_PROFILE=ON）
+    // 帧节奏：--pace vsync|uncapped|adaptive|limit  --fps 144（limit 用）  --frames-in-flight 1..4（0 不限）
+    //   --pace-stats：每 2 秒打印实际帧时间（退出时总会打印一行汇总）
+    // --jobs N：阴影 hull 重建用 N 个额外工作线程（默认核数 - 1，0 = 串行）
+    // --threaded：模拟放到单独线程，渲染只读它经三缓冲发布的最新状态（不能和 --record / --replay 同用）
+    // --gl-stats：每 2 秒打印一次上一帧 GL 状态调用的发出 / 过滤次数，以及顶点流等 GPU 的次数
+    double tickHz = 120.0;
+    int maxSteps = 8;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    LevelGenParams levelGen;
+    bool useGeneratedLevel = false;
+    bool printGlStats = false;
+    bool cpuShadowMesh = false;
+    int maskScale = 1;
+    bool maskEdgeAware = true;
+    ShadowComposite composite = ShadowComposite::MaskFbo;
+    bool compositeAB = false;
+    bool shadowScissor = true;
+    bool printProfile = false;
+    const char* profileCsv = nullptr;
+    FramePacerConfig pacing;
+    bool printPaceStats = false;
+    bool threaded = false;
+    int jobWorkers = JobSystem::defaultWorkerCount();
+    for (int i = 1; i < argc; ++i) {
+        if (parseLevelGenArg(argc, argv, i, levelGen, useGeneratedLevel)) continue;
+        if (!std::strcmp(argv[i], "--tick-hz") && i + 1 < argc) tickHz = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--max-steps") && i + 1 < argc) maxSteps = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--record") && i + 1 < argc) recordPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--replay") && i + 1 < argc) replayPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--gl-stats")) printGlStats = true;
+        else if (!std::strcmp(argv[i], "--shadow-composite") && i + 1 < argc)
+            composite = !std::strcmp(argv[++i], "stencil") ? ShadowComposite::Stencil : ShadowComposite::MaskFbo;
+        else if (!std::strcmp(argv[i], "--composite-ab")) compositeAB = true;
+        else if (!std::strcmp(argv[i], "--no-shadow-scissor")) shadowScissor = false;
+        else if (!std::strcmp(argv[i], "--profile")) printProfile = true;
+        else if (!std::strcmp(argv[i], "--profile-csv") && i + 1 < argc) profileCsv = argv[++i];
+        else if (!std::strcmp(argv[i], "--pace") && i + 1 < argc) {
+            if (!parsePaceMode(argv[++i], pacing.mode)) std::cerr << "Unknown --pace mode " << argv[i] << ", using vsync\n";
+        }
+        else if (!std::strcmp(argv[i], "--fps") && i + 1 < argc) pacing.targetFps = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames-in-flight") && i + 1 < argc) pacing.maxFramesInFlight = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--pace-stats")) printPaceStats = true;
+        else if (!std::strcmp(argv[i], "--threaded")) threaded = true;
+        else if (!std::strcmp(argv[i], "--jobs") && i + 1 < argc) jobWorkers = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--cpu-shadow-mesh")) cpuShadowMesh = true;
+        else if (!std::strcmp(argv[i], "--mask-scale") && i + 1 < argc) maskScale = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--mask-upsample") && i + 1 < argc) maskEdgeAware = std::strcmp(argv[++i], "bilinear") != 0;
+    }
+
+    // 录制 / 回放按渲染帧切 tick，模拟线程的 tick 与帧无关，两者不兼容
+    if (threaded && (recordPath || replayPath)) {
+        std::cerr << "--threaded cannot be combined with --record / --replay; running single-threaded\n";
+        threaded = false;
+    }
+
+    // 回放：tick 频率 / 每帧步数上限以文件为准
+    std::unique_ptr<InputReplay> replay;
+    try {
+        if (replayPath) {
+            replay = std::make_unique<InputReplay>(replayPath);
+            tickHz = replay->tickHz();
+            maxSteps = replay->maxStepsPerFrame();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal: " << e.what() << "\n";
+        return 1;
+    }
+
     glfwSetErrorCallback(glfwErrorCallback);
     if (!glfwInit()) return 1;
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_STENCIL_BITS, 8);   // ShadowComposite::Stencil 用
 
     const int W = 1280;
     const int H = 720;
@@ -36,7 +146,6 @@ int main() {
         return 1;
     }
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
 
     glewExperimental = GL_TRUE;
     if (glewInit() != GLEW_OK) {
@@ -51,14 +160,53 @@ int main() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     try {
+        // 先于 scene 构造：world 持有它的指针，scene（及模拟线程）析构完它才退出
+        JobSystem jobs(jobWorkers);
         Scene scene(W, H);
+        scene.world().setJobSystem(&jobs);
+        scene.setGpuShadowProjection(!cpuShadowMesh);
+        scene.setShadowMaskScale(maskScale, maskEdgeAware);
+        scene.setShadowComposite(composite);
+        scene.setShadowScissor(shadowScissor);
+        if (useGeneratedLevel) {
+            GeneratedLevel level = generateLevel(levelGen);
+            scene.loadLevel(std::move(level.objects), level.lightSpawn);
+        }
         glfwSetWindowUserPointer(window, &scene);
         glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
 
+        // A/B 对比合成方式时不能被 vsync 卡住
+        if (compositeAB) pacing.mode = PaceMode::Uncapped;
+        FramePacer pacer(pacing);
+        std::cout << "Frame pacing: " << pacer.describe() << "\n";
+
+        FixedStepClock clock(tickHz, maxSteps);
+        const float tickDt = static_cast<float>(clock.tickDt());
+
+        InputRecorder recorder;
+        if (recordPath) recorder.open(recordPath, tickHz, maxSteps);
+        std::vector<InputState> ticks;
+
+        // 模拟线程独占 scene.world()；在 scene 之后构造，先于 scene 析构（join）
+        std::unique_ptr<SimThread> sim;
+        if (threaded) {
+            sim = std::make_unique<SimThread>(scene.world(), tickHz, maxSteps);
+            sim->setCaptureHulls(!scene.gpuShadowProjection());
+            sim->start();
+            std::cout << "Simulation thread started (" << tickHz << " Hz)\n";
+        }
+
         double last = glfwGetTime();
+        double nextStatsAt = last + 2.0;
+        bool toggleHeld = false;
+        bool compositeHeld = false;
+        // --composite-ab：当前窗口内的帧数 / 帧时间累计
+        double abStart = last;
+        int abFrames = 0;
         while (!glfwWindowShouldClose(window)) {
+            pacer.beginFrame();
             const double now = glfwGetTime();
-            const float dt = static_cast<float>(now - last);
+            double frameDt = now - last;
             last = now;
 
             glfwPollEvents();
@@ -67,15 +215,113 @@ int main() {
                 glfwSetWindowShouldClose(window, GLFW_TRUE);
             }
 
-            scene.update(window, dt);
-            scene.render();
+            // M：切换阴影 mask 来源（纯渲染开关，不进录像）
+            const bool toggleDown = glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS;
+            if (toggleDown && !toggleHeld) {
+                scene.setGpuShadowProjection(!scene.gpuShadowProjection());
+                if (sim) sim->setCaptureHulls(!scene.gpuShadowProjection());
+                std::cout << "Shadow mask: " << (scene.gpuShadowProjection() ? "GPU projection" : "CPU hull mesh") << "\n";
+            }
+            toggleHeld = toggleDown;
+
+            // N：切换阴影合成方式
+            const bool compositeDown = glfwGetKey(window, GLFW_KEY_N) == GLFW_PRESS;
+            if (compositeDown && !compositeHeld) {
+                const bool toStencil = scene.shadowComposite() == ShadowComposite::MaskFbo;
+                scene.setShadowComposite(toStencil ? ShadowComposite::Stencil : ShadowComposite::MaskFbo);
+                std::cout << "Shadow composite: " << (toStencil ? "stencil" : "mask FBO") << "\n";
+            }
+            compositeHeld = compositeDown;
+
+            if (sim) {
+                // 模拟线程自己按 tick 跑；这里只交输入、画最新发布的状态（还没发布过就先不画）
+                sim->setInput(pollInput(window));
+                if (const SimFrame* frame = sim->latest()) scene.render(*frame, sim->alpha(*frame));
+            } else {
+                // 固定步长推进模拟；渲染按剩余时间插值
+                int steps = 0;
+                if (replay) {
+                    // 回放：帧时间和每个 tick 的输入都来自文件，时钟只用来算插值 alpha
+                    if (!replay->nextFrame(frameDt, ticks)) {
+                        std::cout << "Replay finished, state hash " << std::hex
+                                  << scene.world().stateHash() << std::dec << "\n";
+                        break;
+                    }
+                    clock.advance(frameDt);
+                    steps = (int)ticks.size();
+                } else {
+                    steps = clock.advance(frameDt);
+                    ticks.assign((size_t)steps, pollInput(window));
+                }
+
+                for (int s = 0; s < steps; ++s) scene.update(ticks[(size_t)s], tickDt);
+                recorder.writeFrame(frameDt, ticks.data(), steps);
+                scene.render(clock.alpha());
+            }
+
+            if (compositeAB) {
+                // 等 GPU 做完再计时，否则量到的只是提交时间
+                glFinish();
+                ++abFrames;
+                const double t = glfwGetTime();
+                if (t - abStart >= 2.0) {
+                    const bool stencil = scene.shadowComposite() == ShadowComposite::Stencil;
+                    std::cout << "[composite] " << (stencil ? "stencil " : "mask FBO") << "  "
+                              << (t - abStart) * 1000.0 / abFrames << " ms/frame over "
+                              << abFrames << " frames\n";
+                    scene.setShadowComposite(stencil ? ShadowComposite::MaskFbo : ShadowComposite::Stencil);
+                    abStart = t;
+                    abFrames = 0;
+                }
+            }
+
+            if ((printGlStats || printProfile || printPaceStats) && now >= nextStatsAt) {
+                nextStatsAt = now + 2.0;
+                if (printPaceStats) {
+                    const FrameTimeStats ps = pacer.stats();
+                    std::cout << "[pace] " << paceModeName(pacer.mode()) << "  " << ps.fps << " fps, frame ms avg "
+                              << ps.avgMs << " min " << ps.minMs << " p99 " << ps.p99Ms << " max " << ps.maxMs
+                              << ", fence waits " << ps.fenceWaits << "\n";
+                }
+                if (printGlStats) {
+                    const RenderStateStats& gs = scene.glStats();
+                    std::cout << "[gl] state calls issued " << gs.issued
+                              << ", suppressed " << gs.suppressed
+                              << ", stream stalls " << scene.shadowStreamStalls() << "\n";
+                }
+#ifdef SHADOWGAME_PROFILE
+                if (printProfile) prof::Profiler::instance().print(std::cout);
+#endif
+            }
 
             glfwSwapBuffers(window);
+            pacer.endFrame();
+        }
+
+        if (sim) {
+            sim->stop();
+            std::cout << "Simulation thread ran " << sim->ticks() << " ticks\n";
         }
+
+        const FrameTimeStats ps = pacer.stats();
+        std::cout << "Frame pacing: " << pacer.describe() << " -> " << ps.fps << " fps (avg "
+                  << ps.avgMs << " ms, p99 " << ps.p99Ms << " ms over last " << ps.frames << " frames)\n";
     } catch (const std::exception& e) {
         std::cerr << "Fatal: " << e.what() << "\n";
     }
 
+#ifdef SHADOWGAME_PROFILE
+    try {
+        if (profileCsv) prof::Profiler::instance().writeCsv(profileCsv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+    }
+#else
+    if (printProfile || profileCsv) {
+        std::cerr << "Profiling not compiled in (configure with -DSHADOWGAME_PROFILE=ON)\n";
+    }
+#endif
+
     glfwDestroyWindow(window);
     glfwTerminate();
     return 0;
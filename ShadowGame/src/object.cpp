@@ -1,63 +1,141 @@
 // File: src/object.cpp
 #include "object.hpp"
 
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
 #include <cstddef>
 #include <stdexcept>
 #include <vector>
 
-BoxObject::BoxObject() {
-    ensureCubeMesh();
+FrameUniformBuffer::FrameUniformBuffer() {
+    glGenBuffers(1, &ubo_);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kFrameDataBinding, ubo_);
 }
 
-BoxObject::BoxObject(const glm::vec3& p, const glm::vec3& s, const glm::vec3& c)
-    : position(p), scale(s), color(c) {
-    ensureCubeMesh();
+FrameUniformBuffer::~FrameUniformBuffer() {
+    if (ubo_) glDeleteBuffers(1, &ubo_);
 }
 
-glm::mat4 BoxObject::model() const {
-    glm::mat4 m(1.0f);
-    m = glm::translate(m, position);
-    m = glm::scale(m, scale);
-    return m;
+void FrameUniformBuffer::update(const FrameData& data) {
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kFrameDataBinding, ubo_);
 }
 
-void BoxObject::draw(const Shader& shader, const glm::mat4& view, const glm::mat4& proj) const {
-    shader.use();
-    shader.setMat4("uModel", model());
-    shader.setMat4("uView", view);
-    shader.setMat4("uProj", proj);
-    shader.setVec3("uColor", color);
+StreamBuffer::~StreamBuffer() {
+    release();
+}
 
-    glBindVertexArray(s_vao);
-    glDrawArrays(GL_TRIANGLES, 0, s_count);
-    glBindVertexArray(0);
+void StreamBuffer::create(GLsizeiptr sliceBytes, GLsizeiptr stride) {
+    persistent_ = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+    stride_ = std::max<GLsizeiptr>(stride, 1);
+    allocate(std::max<GLsizeiptr>(sliceBytes, 256));
 }
 
-std::array<glm::vec3, 8> BoxObject::worldCorners() const {
-    const glm::mat4 m = model();
-    const std::array<glm::vec3, 8> local = {
-        glm::vec3(-0.5f, -0.5f, -0.5f),
-        glm::vec3( 0.5f, -0.5f, -0.5f),
-        glm::vec3( 0.5f,  0.5f, -0.5f),
-        glm::vec3(-0.5f,  0.5f, -0.5f),
-        glm::vec3(-0.5f, -0.5f,  0.5f),
-        glm::vec3( 0.5f, -0.5f,  0.5f),
-        glm::vec3( 0.5f,  0.5f,  0.5f),
-        glm::vec3(-0.5f,  0.5f,  0.5f),
-    };
+void StreamBuffer::allocate(GLsizeiptr sliceBytes) {
+    // 向上取到 stride_ 的整数倍：slice 起点 = slice_ * sliceBytes_ 才能整除 stride_
+    sliceBytes_ = (sliceBytes + stride_ - 1) / stride_ * stride_;
+    const GLsizeiptr total = sliceBytes_ * kSlices;
 
-    std::array<glm::vec3, 8> out{};
-    for (int i = 0; i < 8; ++i) {
-        const glm::vec4 wp = m * glm::vec4(local[i], 1.0f);
-        out[i] = glm::vec3(wp);
+    if (persistent_) {
+        // immutable storage 不能改大小：换一个新 buffer（旧的等 GPU 用完由驱动回收）
+        release();
+        glGenBuffers(1, &vbo_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, total, nullptr, flags);
+        mapped_ = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (!mapped_) throw std::runtime_error("StreamBuffer: persistent map failed");
+    } else {
+        // orphan：旧存储交给驱动，fence 也随之作废
+        if (!vbo_) glGenBuffers(1, &vbo_);
+        for (GLsync& f : fences_) {
+            if (f) glDeleteSync(f);
+            f = nullptr;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        glBufferData(GL_ARRAY_BUFFER, total, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
-    return out;
+    slice_ = kSlices - 1;
 }
 
-void BoxObject::ensureCubeMesh() {
-    if (s_inited) return;
-    s_inited = true;
+void StreamBuffer::release() {
+    for (GLsync& f : fences_) {
+        if (f) glDeleteSync(f);
+        f = nullptr;
+    }
+    if (vbo_) {
+        if (mapped_) {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &vbo_);
+    }
+    vbo_ = 0;
+    mapped_ = nullptr;
+}
+
+void StreamBuffer::waitSlice(int slice) {
+    GLsync& f = fences_[(size_t)slice];
+    if (!f) return;
+    GLenum r = glClientWaitSync(f, 0, 0);
+    if (r == GL_TIMEOUT_EXPIRED) {
+        ++stalls_;
+        do {
+            r = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);   // 1ms
+        } while (r == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(f);
+    f = nullptr;
+}
+
+void* StreamBuffer::map(GLsizeiptr bytes) {
+    if (bytes > sliceBytes_) {
+        GLsizeiptr grown = sliceBytes_;
+        while (grown < bytes) grown *= 2;
+        allocate(grown);
+    }
 
+    slice_ = (slice_ + 1) % kSlices;
+    waitSlice(slice_);
+    writing_ = true;
+
+    const GLintptr offset = (GLintptr)slice_ * sliceBytes_;
+    if (persistent_) return mapped_ + offset;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    void* p = glMapBufferRange(GL_ARRAY_BUFFER, offset, bytes,
+                               GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!p) throw std::runtime_error("StreamBuffer: glMapBufferRange failed");
+    return p;
+}
+
+GLint StreamBuffer::unmap() {
+    if (writing_ && !persistent_) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    writing_ = false;
+    return (GLint)((GLintptr)slice_ * (sliceBytes_ / stride_));
+}
+
+void StreamBuffer::fence() {
+    GLsync& f = fences_[(size_t)slice_];
+    if (f) glDeleteSync(f);
+    f = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+BoxMesh::BoxMesh() {
     const std::vector<VertexPN> verts = {
         // +Z
         {{-0.5f,-0.5f, 0.5f},{0,0,1}}, {{ 0.5f,-0.5f, 0.5f},{0,0,1}}, {{ 0.5f, 0.5f, 0.5f},{0,0,1}},
@@ -79,13 +157,13 @@ void BoxObject::ensureCubeMesh() {
         {{-0.5f,-0.5f,-0.5f},{0,-1,0}}, {{ 0.5f,-0.5f, 0.5f},{0,-1,0}}, {{-0.5f,-0.5f, 0.5f},{0,-1,0}},
     };
 
-    s_count = static_cast<GLsizei>(verts.size());
+    count_ = static_cast<GLsizei>(verts.size());
 
-    glGenVertexArrays(1, &s_vao);
-    glGenBuffers(1, &s_vbo);
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
 
-    glBindVertexArray(s_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, s_vbo);
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(VertexPN), verts.data(), GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
@@ -94,5 +172,96 @@ void BoxObject::ensureCubeMesh() {
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VertexPN), (void*)offsetof(VertexPN, nrm));
 
+    // per-instance：location 2..5，每个实例前进一次
+    glGenBuffers(1, &instanceVbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
+    glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+
+    const GLsizei stride = sizeof(BoxInstance);
+    const size_t offsets[4] = {
+        offsetof(BoxInstance, center),
+        offsetof(BoxInstance, scale),
+        offsetof(BoxInstance, invScale),
+        offsetof(BoxInstance, color),
+    };
+    for (GLuint i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(2 + i);
+        glVertexAttribPointer(2 + i, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsets[i]);
+        glVertexAttribDivisor(2 + i, 1);
+    }
+
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+BoxMesh::~BoxMesh() {
+    if (instanceVbo_) glDeleteBuffers(1, &instanceVbo_);
+    if (vbo_) glDeleteBuffers(1, &vbo_);
+    if (vao_) glDeleteVertexArrays(1, &vao_);
+}
+
+void BoxMesh::uploadInstances(const std::vector<BoxObject>& boxes) {
+    staging_.resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        const BoxObject& b = boxes[i];
+        BoxInstance& inst = staging_[i];
+        inst.center = b.position;
+        inst.scale = b.scale;
+        inst.invScale = glm::vec3(1.0f / b.scale.x, 1.0f / b.scale.y, 1.0f / b.scale.z);
+        inst.color = b.color;
+    }
+    instanceCount_ = (GLsizei)staging_.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo_);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(staging_.size() * sizeof(BoxInstance)), staging_.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void BoxMesh::drawInstanced(RenderState& rs) const {
+    if (instanceCount_ <= 0) return;
+    rs.bindVertexArray(vao_);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, count_, instanceCount_);
+}
+
+BallMesh::BallMesh(int segments) {
+    std::vector<glm::vec3> verts;
+    verts.reserve((size_t)segments + 2);
+
+    verts.push_back(glm::vec3(0.0f, 0.0f, 0.03f));
+    for (int i = 0; i <= segments; ++i) {
+        const float a = (float)i / (float)segments * 2.0f * 3.1415926f;
+        verts.push_back(glm::vec3(std::cos(a), std::sin(a), 0.03f));
+    }
+    count_ = (GLsizei)verts.size();
+
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &vbo_);
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(verts.size() * sizeof(glm::vec3)), verts.data(), GL_STATIC_DRAW);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glBindVertexArray(0);
+}
+
+BallMesh::~BallMesh() {
+    if (vbo_) glDeleteBuffers(1, &vbo_);
+    if (vao_) glDeleteVertexArrays(1, &vao_);
+}
+
+void BallMesh::draw(RenderState& rs, const Shader& shader, const glm::vec2& at, float radius) const {
+    shader.use(rs);
+
+    glm::mat4 m(1.0f);
+    m = glm::translate(m, glm::vec3(at.x, at.y, 0.0f));
+    m = glm::scale(m, glm::vec3(radius, radius, 1.0f));
+
+    const Shader::HotUniforms& u = shader.hot();
+    shader.setMat4(u.uModel, m);
+    shader.setInt(u.uMode, 0);
+    shader.setVec4(u.uColor4, glm::vec4(0.90f, 0.20f, 0.20f, 1.0f));
+
+    rs.bindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, count_);
 }
@@ -168,13 +168,20 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "box.hpp"
+#include "render_state.hpp"
+
 class Shader final {
 public:
     GLuint program = 0;
@@ -187,11 +194,14 @@ public:
     Shader(const Shader&) = delete;
     Shader& operator=(const Shader&) = delete;
 
-    Shader(Shader&& other) noexcept { program = other.program; other.program = 0; }
+    Shader(Shader&& other) noexcept
+        : program(other.program), uniforms_(std::move(other.uniforms_)), hot_(other.hot_) { other.program = 0; }
     Shader& operator=(Shader&& other) noexcept {
         if (this != &other) {
             if (program) glDeleteProgram(program);
             program = other.program;
+            uniforms_ = std::move(other.uniforms_);
+            hot_ = other.hot_;
             other.program = 0;
         }
         return *this;
@@ -227,10 +237,36 @@ public:
 
         if (program) glDeleteProgram(program);
         program = prog;
+        cacheUniformLocations();
     }
 
     void use() const { glUseProgram(program); }
-    GLint loc(const char* name) const { return glGetUniformLocation(program, name); }
+    // 渲染 pass 里走状态缓存
+    void use(RenderState& rs) const { rs.useProgram(program); }
+
+    // 链接时已把所有 active uniform 的位置缓存下来；不存在（或被编译器优化掉）返回 -1，GL 会忽略
+    GLint loc(const char* name) const {
+        for (const UniformSlot& u : uniforms_)
+            if (std::strcmp(u.name.c_str(), name) == 0) return u.location;
+        return -1;
+    }
+
+    // 每次 draw 都要设的 uniform：链接后解析一次，热路径直接传 location，不再按名字查
+    struct HotUniforms {
+        GLint uModel = -1;
+        GLint uMode = -1;
+        GLint uColor = -1;
+        GLint uColor4 = -1;
+        GLint uUseLighting = -1;
+        GLint uAmbient = -1;
+    };
+    const HotUniforms& hot() const { return hot_; }
+
+    // uniform block 绑到 binding 点（330 没有 layout(binding=)，只能在 C++ 端绑）
+    void bindUniformBlock(const char* blockName, GLuint binding) const {
+        const GLuint idx = glGetUniformBlockIndex(program, blockName);
+        if (idx != GL_INVALID_INDEX) glUniformBlockBinding(program, idx, binding);
+    }
 
     void setMat4(const char* name, const glm::mat4& m) const {
         glUniformMatrix4fv(loc(name), 1, GL_FALSE, glm::value_ptr(m));
@@ -247,7 +283,53 @@ public:
     void setFloat(const char* name, float v) const { glUniform1f(loc(name), v); }
     void setInt(const char* name, int v) const { glUniform1i(loc(name), v); }
 
+    // 按 location 设（location 来自 hot()）
+    void setMat4(GLint location, const glm::mat4& m) const {
+        glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(m));
+    }
+    void setVec4(GLint location, const glm::vec4& v) const { glUniform4fv(location, 1, glm::value_ptr(v)); }
+    void setVec3(GLint location, const glm::vec3& v) const { glUniform3fv(location, 1, glm::value_ptr(v)); }
+    void setFloat(GLint location, float v) const { glUniform1f(location, v); }
+    void setInt(GLint location, int v) const { glUniform1i(location, v); }
+
 private:
+    struct UniformSlot {
+        std::string name;
+        GLint location = -1;
+    };
+    std::vector<UniformSlot> uniforms_;
+    HotUniforms hot_;
+
+    // 枚举 default block 里的 uniform（block 成员 location 为 -1，跳过）
+    void cacheUniformLocations() {
+        uniforms_.clear();
+        GLint count = 0, maxLen = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+        std::string buf((size_t)std::max(maxLen, 1), '\0');
+
+        for (GLint i = 0; i < count; ++i) {
+            GLsizei len = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(program, (GLuint)i, (GLsizei)buf.size(), &len, &size, &type, buf.data());
+            std::string name(buf.data(), (size_t)len);
+            const GLint location = glGetUniformLocation(program, name.c_str());
+            if (location < 0) continue;
+            // 数组 uniform 报告为 "name[0]"，按不带下标的名字查
+            const size_t bracket = name.find('[');
+            if (bracket != std::string::npos) name.resize(bracket);
+            uniforms_.push_back({std::move(name), location});
+        }
+
+        hot_.uModel = loc("uModel");
+        hot_.uMode = loc("uMode");
+        hot_.uColor = loc("uColor");
+        hot_.uColor4 = loc("uColor4");
+        hot_.uUseLighting = loc("uUseLighting");
+        hot_.uAmbient = loc("uAmbient");
+    }
+
     static std::string readTextFile(const std::string& path) {
         std::ifstream in(path);
         if (!in) throw std::runtime_error("Failed to open file: " + path);
@@ -275,30 +357,138 @@ private:
     }
 };
 
+// 每帧共享的 uniform（std140），object / background 两个 program 都用 binding 0 的 FrameData 块。
+// 成员顺序、padding 必须和 shaders 里的 FrameData 一一对应。
+constexpr GLuint kFrameDataBinding = 0;
+
+struct FrameData {
+    glm::mat4 view{1.0f};
+    glm::mat4 proj{1.0f};
+    glm::vec4 viewPos{0.0f};      // xyz
+    glm::vec4 lightPos{0.0f};     // xyz
+    glm::vec4 lightDir{0.0f};     // xyz：光源指向光圈中心
+    glm::vec4 lightColor{1.0f};   // rgb
+    glm::vec4 footprint{0.0f};    // xy 光圈中心，z 半径，w 软边宽度
+    glm::vec4 lightCone{1.0f};    // x innerCut，y outerCut（cos）
+    glm::vec4 resolution{1.0f};   // xy 帧缓冲尺寸，zw 倒数
+};
+static_assert(sizeof(FrameData) == 2 * 64 + 7 * 16, "FrameData must match the std140 block layout");
+
+class FrameUniformBuffer final {
+public:
+    FrameUniformBuffer();
+    ~FrameUniformBuffer();
+
+    FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+    FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+    // 每帧一次：整块 glBufferSubData，然后挂到 kFrameDataBinding
+    void update(const FrameData& data);
+
+private:
+    GLuint ubo_ = 0;
+};
+
+// 每帧（或隔几帧）整块重写的动态顶点流。一个 buffer 切成 kSlices 段轮流写，
+// 每段用 glFenceSync 记住 GPU 最后一次读它的位置，回绕时只在 GPU 还没读完时才等。
+//   - 有 ARB_buffer_storage / GL 4.4：glBufferStorage + persistent coherent 映射，只映射一次
+//   - GL 3.3：每次 glMapBufferRange(UNSYNCHRONIZED | INVALIDATE_RANGE)，同步完全靠 fence
+// 用法：p = map(bytes) -> 直接写 -> first = unmap() -> draw -> fence()
+class StreamBuffer final {
+public:
+    static constexpr int kSlices = 3;
+
+    StreamBuffer() = default;
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // 建 buffer；sliceBytes 是每段初始容量，写不下时 map() 会按 2 倍扩容
+    // stride 是一个元素（顶点）的字节数：slice 大小总是向上取到它的整数倍，
+    // 这样每个 slice 的起点都落在元素边界上，glDrawArrays 的 first 才是精确的
+    void create(GLsizeiptr sliceBytes, GLsizeiptr stride);
+
+    // 拿下一个 slice 的写指针（至少 bytes 字节）
+    void* map(GLsizeiptr bytes);
+    // 结束写入；返回这次数据在 buffer 里的起始元素下标（直接给 glDrawArrays 的 first）
+    GLint unmap();
+    // 读当前 slice 的 draw 提交之后调用
+    void fence();
+
+    // persistent 路径扩容时会换成新的 buffer 对象，VAO 需要重新指向它
+    GLuint id() const { return vbo_; }
+    bool persistent() const { return persistent_; }
+    // 回绕时真的等了 GPU 的次数（应该一直是 0）
+    std::uint64_t stalls() const { return stalls_; }
+
+private:
+    GLuint vbo_ = 0;
+    GLsizeiptr sliceBytes_ = 0;   // 总是 stride_ 的整数倍
+    GLsizeiptr stride_ = 1;
+    bool persistent_ = false;
+    char* mapped_ = nullptr;   // persistent 映射的起点
+    int slice_ = kSlices - 1;
+    bool writing_ = false;
+    std::array<GLsync, kSlices> fences_{};
+    std::uint64_t stalls_ = 0;
+
+    void allocate(GLsizeiptr sliceBytes);
+    void release();
+    void waitSlice(int slice);
+};
+
 struct VertexPN {
     glm::vec3 pos;
     glm::vec3 nrm;
 };
 
-class BoxObject final {
+// 单位立方体 mesh（36 顶点，pos + normal），所有 BoxObject 共用一份。
+// 盒子只有平移+缩放，所以每实例只存 center / scale / 1/scale（法线变换）/ color，
+// 整个关卡一次 glDrawArraysInstanced 画完。
+struct BoxInstance {
+    glm::vec3 center;
+    glm::vec3 scale;
+    glm::vec3 invScale;   // 法线矩阵 = diag(1/scale)，shader 里再 normalize
+    glm::vec3 color;
+};
+
+class BoxMesh final {
+public:
+    BoxMesh();
+    ~BoxMesh();
+
+    BoxMesh(const BoxMesh&) = delete;
+    BoxMesh& operator=(const BoxMesh&) = delete;
+
+    // 盒子集合变了才需要调（整块重传）
+    void uploadInstances(const std::vector<BoxObject>& boxes);
+    // 调用方先 use()；矩阵和光照来自 FrameData
+    void drawInstanced(RenderState& rs) const;
+
+private:
+    GLuint vao_ = 0, vbo_ = 0;
+    GLuint instanceVbo_ = 0;
+    GLsizei count_ = 0;
+    GLsizei instanceCount_ = 0;
+    std::vector<BoxInstance> staging_;
+};
+
+// 球：z=0.03 的单位圆 triangle fan，绘制时按半径缩放
+class BallMesh final {
 public:
-    glm::vec3 position{0.0f};
-    glm::vec3 scale{1.0f};
-    glm::vec3 color{0.8f, 0.8f, 0.85f};
+    explicit BallMesh(int segments = 48);
+    ~BallMesh();
 
-    BoxObject();
-    BoxObject(const glm::vec3& p, const glm::vec3& s, const glm::vec3& c);
+    BallMesh(const BallMesh&) = delete;
+    BallMesh& operator=(const BallMesh&) = delete;
 
-    glm::mat4 model() const;
-    void draw(const Shader& shader, const glm::mat4& view, const glm::mat4& proj) const;
-    std::array<glm::vec3, 8> worldCorners() const;
+    // at：绘制位置（插值后的 pos）；view / proj 来自 FrameData
+    void draw(RenderState& rs, const Shader& shader, const glm::vec2& at, float radius) const;
 
 private:
-    static inline bool s_inited = false;
-    static inline GLuint s_vao = 0;
-    static inline GLuint s_vbo = 0;
-    static inline GLsizei s_count = 0;
-    static void ensureCubeMesh();
+    GLuint vao_ = 0, vbo_ = 0;
+    GLsizei count_ = 0;
 };
 
 #endif
@@ -4,24 +4,25 @@
 #include "people.hpp"
 #include <algorithm>
 
-void FlashlightOperator::update(GLFWwindow* window, float dt) {
+void FlashlightOperator::update(const InputState& in, float dt) {
     if (!light_) return;
 
     glm::vec2 delta(0.0f);
-    if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)  delta.x -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) delta.x += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)  delta.y -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)    delta.y += 1.0f;
+    if (in.held(kInputLightLeft))  delta.x -= 1.0f;
+    if (in.held(kInputLightRight)) delta.x += 1.0f;
+    if (in.held(kInputLightDown))  delta.y -= 1.0f;
+    if (in.held(kInputLightUp))    delta.y += 1.0f;
 
     if (glm::length(delta) > 0.0f) {
         delta = glm::normalize(delta);
         const glm::vec2 applied = delta * light_->moveSpeed * dt;
         light_->position.x += applied.x;
         light_->position.y += applied.y;
+        light_->touch();
     }
 
-    if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS)
+    if (in.held(kInputFovNarrow))
         light_->fovDeg = std::max(10.0f, light_->fovDeg - 40.0f * dt);
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
+    if (in.held(kInputFovWiden))
         light_->fovDeg = std::min(80.0f, light_->fovDeg + 40.0f * dt);
 }
\ No newline at end of file
@@ -5,14 +5,14 @@
 #ifndef PEOPLE_HPP
 #define PEOPLE_HPP
 
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
+#include "input.hpp"
 #include "LightSource.hpp"
 
 class FlashlightOperator final {
 public:
     explicit FlashlightOperator(LightSource* light) : light_(light) {}
-    void update(GLFWwindow* window, float dt);
+    void update(const InputState& in, float dt);
 
 private:
     LightSource* light_ = nullptr;
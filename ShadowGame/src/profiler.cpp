@@ -0,0 +1,104 @@
+// File: src/profiler.cpp
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+namespace prof {
+
+Profiler& Profiler::instance() {
+    static Profiler p;
+    return p;
+}
+
+int Profiler::section(const char* name) {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (size_t i = 0; i < sections_.size(); ++i) {
+        if (sections_[i].name == name) return (int)i;
+    }
+    sections_.push_back(Section{});
+    sections_.back().name = name;
+    return (int)sections_.size() - 1;
+}
+
+void Profiler::record(int id, double us) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (id < 0 || id >= (int)sections_.size()) return;
+    Section& s = sections_[(size_t)id];
+    s.ring[(size_t)s.head] = (float)us;
+    s.head = (s.head + 1) % kWindow;
+    s.count = std::min(s.count + 1, kWindow);
+}
+
+std::vector<SectionStats> Profiler::stats() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    std::vector<SectionStats> out;
+    out.reserve(sections_.size());
+
+    std::vector<float> sorted;
+    for (const Section& s : sections_) {
+        SectionStats st;
+        st.name = s.name;
+        st.samples = s.count;
+        if (s.count > 0) {
+            // 窗口没满时有效样本是 [0, count)；满了以后整圈都有效，顺序无关
+            sorted.assign(s.ring.begin(), s.ring.begin() + s.count);
+            std::sort(sorted.begin(), sorted.end());
+            double sum = 0.0;
+            for (float v : sorted) sum += v;
+            const size_t p99 = std::min(sorted.size() - 1, (size_t)((double)sorted.size() * 0.99));
+            st.minUs = sorted.front();
+            st.avgUs = sum / (double)sorted.size();
+            st.p99Us = sorted[p99];
+            st.maxUs = sorted.back();
+        }
+        out.push_back(std::move(st));
+    }
+    return out;
+}
+
+void Profiler::writeCsv(std::ostream& os) const {
+    os << "section,samples,min_us,avg_us,p99_us,max_us\n";
+    for (const SectionStats& s : stats()) {
+        os << s.name << ',' << s.samples << ','
+           << s.minUs << ',' << s.avgUs << ',' << s.p99Us << ',' << s.maxUs << '\n';
+    }
+}
+
+void Profiler::writeCsv(const std::string& path) const {
+    std::ofstream f(path);
+    if (!f) throw std::runtime_error("Profiler: cannot open " + path);
+    writeCsv(f);
+}
+
+void Profiler::print(std::ostream& os) const {
+    const std::vector<SectionStats> all = stats();
+    size_t w = 8;
+    for (const SectionStats& s : all) w = std::max(w, s.name.size());
+
+    const auto flags = os.flags();
+    const auto prec = os.precision();
+    os << std::left << std::setw((int)w) << "section" << std::right
+       << std::setw(8) << "n" << std::setw(10) << "min us" << std::setw(10) << "avg us"
+       << std::setw(10) << "p99 us" << std::setw(10) << "max us" << "\n";
+    os << std::fixed << std::setprecision(1);
+    for (const SectionStats& s : all) {
+        os << std::left << std::setw((int)w) << s.name << std::right
+           << std::setw(8) << s.samples << std::setw(10) << s.minUs << std::setw(10) << s.avgUs
+           << std::setw(10) << s.p99Us << std::setw(10) << s.maxUs << "\n";
+    }
+    os.flags(flags);
+    os.precision(prec);
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (Section& s : sections_) {
+        s.head = 0;
+        s.count = 0;
+    }
+}
+
+} // namespace prof
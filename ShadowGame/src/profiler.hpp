@@ -0,0 +1,101 @@
+// ============================================================================
+// File: src/profiler.hpp
+// 帧内分段计时：CPU 用 SG_PROFILE_SCOPE("update/rebuild") 包一段作用域，
+// GPU 的 pass 耗时（timer query 读回后）也用 record() 写进来。
+// 每个分段保留最近 kWindow 个样本，可以算 min / avg / p99 / max 并导出 CSV。
+//
+// 只有定义了 SHADOWGAME_PROFILE（CMake: -DSHADOWGAME_PROFILE=ON）时宏才展开；
+// 否则 SG_PROFILE_SCOPE 是空语句，热路径上什么都不剩。
+// ============================================================================
+#pragma once
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace prof {
+
+struct SectionStats {
+    std::string name;
+    int samples = 0;      // 窗口内样本数
+    double minUs = 0.0;
+    double avgUs = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+};
+
+class Profiler final {
+public:
+    static constexpr int kWindow = 512;
+
+    // 进程内唯一一份（CPU scope 的宏直接用它）
+    static Profiler& instance();
+
+    // 名字 -> 分段 id（同名返回同一个）；宏里只在第一次经过时调用
+    int section(const char* name);
+
+    // 写一个样本（微秒）；sim 线程 / 渲染线程都可能调用
+    void record(int id, double us);
+
+    std::vector<SectionStats> stats() const;
+    // 一行一个分段：section,samples,min_us,avg_us,p99_us,max_us
+    void writeCsv(std::ostream& os) const;
+    // 写到文件；失败抛 std::runtime_error
+    void writeCsv(const std::string& path) const;
+    // 人读的表格
+    void print(std::ostream& os) const;
+
+    void reset();
+
+private:
+    struct Section {
+        std::string name;
+        std::array<float, kWindow> ring{};
+        int head = 0;
+        int count = 0;
+    };
+
+    mutable std::mutex mu_;
+    std::vector<Section> sections_;
+
+    Profiler() = default;
+};
+
+// 作用域计时：析构时把经过的时间写进 id 对应的分段
+class CpuScope final {
+public:
+    explicit CpuScope(int id) : id_(id), t0_(std::chrono::steady_clock::now()) {}
+    ~CpuScope() {
+        const auto t1 = std::chrono::steady_clock::now();
+        Profiler::instance().record(id_, std::chrono::duration<double, std::micro>(t1 - t0_).count());
+    }
+
+    CpuScope(const CpuScope&) = delete;
+    CpuScope& operator=(const CpuScope&) = delete;
+
+private:
+    int id_;
+    std::chrono::steady_clock::time_point t0_;
+};
+
+} // namespace prof
+
+#define SG_PROFILE_CONCAT_(a, b) a##b
+#define SG_PROFILE_CONCAT(a, b) SG_PROFILE_CONCAT_(a, b)
+
+#ifdef SHADOWGAME_PROFILE
+#define SG_PROFILE_SCOPE(name)                                                           \
+    static const int SG_PROFILE_CONCAT(sgProfId_, __LINE__) =                            \
+        ::prof::Profiler::instance().section(name);                                      \
+    const ::prof::CpuScope SG_PROFILE_CONCAT(sgProfScope_, __LINE__)(SG_PROFILE_CONCAT(sgProfId_, __LINE__))
+#else
+#define SG_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // PROFILER_HPP
@@ -0,0 +1,168 @@
+// ============================================================================
+// File: src/render_state.hpp
+// GL 状态缓存：渲染 pass 都从这里改 program / VAO / 纹理 / FBO / blend / depth / stencil / scissor，
+// 和当前值相同的调用直接丢掉，并统计每帧真正发出 vs. 被过滤掉的次数。
+// 绕过它直接改 GL 状态后（例如重建 FBO），要 invalidate()。
+// ============================================================================
+#pragma once
+#ifndef RENDER_STATE_HPP
+#define RENDER_STATE_HPP
+
+#include <GL/glew.h>
+
+#include <array>
+
+struct RenderStateStats {
+    int issued = 0;       // 真正调用了 gl*
+    int suppressed = 0;   // 与缓存相同被过滤
+};
+
+class RenderState final {
+public:
+    static constexpr int kTextureUnits = 8;
+
+    // 下一帧开始：把本帧计数存起来、清零
+    void beginFrame() {
+        last_ = cur_;
+        cur_ = RenderStateStats{};
+    }
+    const RenderStateStats& lastFrame() const { return last_; }
+
+    // 缓存全部作废：下一次每个 setter 都会真正发出
+    void invalidate() {
+        program_ = vao_ = fbo_ = kUnknown;
+        activeUnit_ = kUnknown;
+        textures_.fill(kUnknown);
+        blend_ = depthTest_ = depthMask_ = kUnknownFlag;
+        blendEq_ = blendSrc_ = blendDst_ = depthFunc_ = kUnknown;
+        stencilTest_ = colorMask_ = kUnknownFlag;
+        stencilFunc_ = {kUnknown, kUnknown, kUnknown};
+        stencilOp_ = {kUnknown, kUnknown, kUnknown};
+        stencilMask_ = kUnknown;
+        scissorTest_ = kUnknownFlag;
+        viewport_ = scissor_ = {-1, -1, -1, -1};
+    }
+
+    RenderState() { invalidate(); }
+
+    void useProgram(GLuint p) {
+        if (filter(program_, p)) glUseProgram(p);
+    }
+    void bindVertexArray(GLuint v) {
+        if (filter(vao_, v)) glBindVertexArray(v);
+    }
+    void bindFramebuffer(GLuint f) {
+        if (filter(fbo_, f)) glBindFramebuffer(GL_FRAMEBUFFER, f);
+    }
+    void bindTexture2D(int unit, GLuint tex) {
+        if (unit < 0 || unit >= kTextureUnits) return;
+        if (textures_[(size_t)unit] == tex) { ++cur_.suppressed; return; }
+        if (filter(activeUnit_, (GLuint)unit)) glActiveTexture(GL_TEXTURE0 + (GLenum)unit);
+        textures_[(size_t)unit] = tex;
+        ++cur_.issued;
+        glBindTexture(GL_TEXTURE_2D, tex);
+    }
+
+    void blend(bool on) {
+        if (filterFlag(blend_, on)) on ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+    }
+    void blendEquation(GLenum eq) {
+        if (filter(blendEq_, eq)) glBlendEquation(eq);
+    }
+    void blendFunc(GLenum src, GLenum dst) {
+        if (blendSrc_ == src && blendDst_ == dst) { ++cur_.suppressed; return; }
+        blendSrc_ = src;
+        blendDst_ = dst;
+        ++cur_.issued;
+        glBlendFunc(src, dst);
+    }
+
+    void depthTest(bool on) {
+        if (filterFlag(depthTest_, on)) on ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+    }
+    void depthFunc(GLenum f) {
+        if (filter(depthFunc_, f)) glDepthFunc(f);
+    }
+    void depthMask(bool on) {
+        if (filterFlag(depthMask_, on)) glDepthMask(on ? GL_TRUE : GL_FALSE);
+    }
+
+    void stencilTest(bool on) {
+        if (filterFlag(stencilTest_, on)) on ? glEnable(GL_STENCIL_TEST) : glDisable(GL_STENCIL_TEST);
+    }
+    void stencilFunc(GLenum func, GLint ref, GLuint mask) {
+        const std::array<GLuint, 3> v{func, (GLuint)ref, mask};
+        if (stencilFunc_ == v) { ++cur_.suppressed; return; }
+        stencilFunc_ = v;
+        ++cur_.issued;
+        glStencilFunc(func, ref, mask);
+    }
+    void stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) {
+        const std::array<GLuint, 3> v{sfail, dpfail, dppass};
+        if (stencilOp_ == v) { ++cur_.suppressed; return; }
+        stencilOp_ = v;
+        ++cur_.issued;
+        glStencilOp(sfail, dpfail, dppass);
+    }
+    void stencilMask(GLuint mask) {
+        if (filter(stencilMask_, mask)) glStencilMask(mask);
+    }
+    // RGBA 一起开关（只有 stencil 标记 pass 需要关）
+    void colorMask(bool on) {
+        if (filterFlag(colorMask_, on)) {
+            const GLboolean b = on ? GL_TRUE : GL_FALSE;
+            glColorMask(b, b, b, b);
+        }
+    }
+
+    void viewport(int x, int y, int w, int h) {
+        const std::array<int, 4> v{x, y, w, h};
+        if (viewport_ == v) { ++cur_.suppressed; return; }
+        viewport_ = v;
+        ++cur_.issued;
+        glViewport(x, y, w, h);
+    }
+
+    void scissorTest(bool on) {
+        if (filterFlag(scissorTest_, on)) on ? glEnable(GL_SCISSOR_TEST) : glDisable(GL_SCISSOR_TEST);
+    }
+    void scissor(int x, int y, int w, int h) {
+        const std::array<int, 4> v{x, y, w, h};
+        if (scissor_ == v) { ++cur_.suppressed; return; }
+        scissor_ = v;
+        ++cur_.issued;
+        glScissor(x, y, w, h);
+    }
+
+private:
+    static constexpr GLuint kUnknown = 0xFFFFFFFFu;
+    static constexpr int kUnknownFlag = -1;
+
+    GLuint program_, vao_, fbo_, activeUnit_;
+    std::array<GLuint, kTextureUnits> textures_;
+    int blend_, depthTest_, depthMask_;
+    GLenum blendEq_, blendSrc_, blendDst_, depthFunc_;
+    int stencilTest_, colorMask_;
+    std::array<GLuint, 3> stencilFunc_, stencilOp_;
+    GLuint stencilMask_;
+    int scissorTest_;
+    std::array<int, 4> viewport_, scissor_;
+
+    RenderStateStats cur_, last_;
+
+    bool filter(GLuint& cached, GLuint v) {
+        if (cached == v) { ++cur_.suppressed; return false; }
+        cached = v;
+        ++cur_.issued;
+        return true;
+    }
+    bool filterFlag(int& cached, bool on) {
+        const int v = on ? 1 : 0;
+        if (cached == v) { ++cur_.suppressed; return false; }
+        cached = v;
+        ++cur_.issued;
+        return true;
+    }
+};
+
+#endif // RENDER_STATE_HPP
@@ -3,79 +3,117 @@
 #define SCENE_HPP
 
 #include <GL/glew.h>
-#include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <vector>
 
 #include "background.hpp"
-#include "camera.hpp"
-#include "LightSource.hpp"
+#include "input.hpp"
 #include "object.hpp"
-#include "people.hpp"
-#include "shadow.hpp"
-
-namespace collision {
-// one-way platform resolve：只提供顶面支撑，返回 groundObjectId
-glm::vec2 resolveCircleAgainstPlatforms(glm::vec2 pos, float radius,
-                                       const std::vector<ShadowPoly>& platforms,
-                                       glm::vec2& vel, bool& grounded, int& groundObjectId);
-} // namespace collision
+#include "render_state.hpp"
+#include "sim_thread.hpp"
+#include "world.hpp"
+#ifdef SHADOWGAME_PROFILE
+#include "gpu_profiler.hpp"
+#else
+// 不编 GpuProfiler：pass 计时宏展开为空（gpuProf_ 成员也不存在）
+#define SG_GPU_PASS(profiler, pass) ((void)0)
+#endif
+
+// 阴影合成方式（运行时可切换）
+enum class ShadowComposite {
+    MaskFbo,   // 离屏 R8 mask（GL_MAX 混合）+ 墙再画一遍采样 mask
+    Stencil,   // 阴影几何写进默认 framebuffer 的 stencil，墙再画一遍，不用离屏目标也不采样纹理
+};
 
 class Scene final {
 public:
     Scene(int w, int h);
     ~Scene();
     void onResize(int w, int h);
-    void update(GLFWwindow* window, float dt);
-    void render();
+    // 推进一个固定 tick（dt 应为 FixedStepClock::tickDt）
+    void update(const InputState& in, float dt);
+    // alpha：上一 tick -> 当前 tick 的插值位置
+    void render(float alpha = 1.0f);
+    // 多线程模式：world() 归模拟线程，渲染只读它发布的 SimFrame
+    void render(const SimFrame& frame, float alpha);
+
+    // 多线程模式下只能在 SimThread start 之前 / stop 之后访问
+    ShadowWorld& world() { return world_; }
+    const ShadowWorld& world() const { return world_; }
+    // 换关卡（例如程序化生成的），下一次 render 重传阴影 mesh / 盒子实例
+    void loadLevel(std::vector<BoxObject> objects, const glm::vec3& lightSpawn);
+    // 最近一次 render 所用状态的阴影缓存命中情况 + 是否重传了 mesh
+    ShadowRebuildStats shadowStats() const;
+    // 上一帧 GL 状态调用：真正发出 vs. 被缓存过滤
+    const RenderStateStats& glStats() const { return gl_.lastFrame(); }
+    // 阴影顶点流回绕时等 GPU 的累计次数
+    std::uint64_t shadowStreamStalls() const { return shadowStream_.stalls(); }
+
+    // 阴影 mask 来源：true（默认）= vertex shader 从光源投影静态盒子，
+    // false = 每次 hull 变化把 CPU 凸包三角化写进顶点流
+    void setGpuShadowProjection(bool on);
+    bool gpuShadowProjection() const { return gpuShadowProjection_; }
+
+    // 阴影 mask 分辨率 = 窗口 / divisor（1、2、4）；edgeAware 只在 divisor > 1 时生效
+    void setShadowMaskScale(int divisor, bool edgeAware);
+
+    void setShadowComposite(ShadowComposite mode);
+    ShadowComposite shadowComposite() const { return shadowComposite_; }
+
+    // 阴影 pass 裁到光圈的屏幕矩形（默认开；关掉用于对比）
+    void setShadowScissor(bool on) { shadowScissor_ = on; }
 
 private:
     int width_ = 1280, height_ = 720;
 
     Shader objectShader_;
     Shader backgroundShader_;
+    Shader shadowProjectShader_;    // shadow_project.vert + background_shader.frag（mode 5）
+    FrameUniformBuffer frameUbo_;   // std140 FrameData，每帧 render 开头写一次
+    RenderState gl_;                // 所有 pass 的 program / VAO / 纹理 / FBO / blend / depth 都经过它
+#ifdef SHADOWGAME_PROFILE
+    GpuProfiler gpuProf_;           // 每个 pass 的 GL_TIME_ELAPSED
+#endif
 
-    Camera camera_;
-    LightSource light_;
-    FlashlightOperator op_;
+    ShadowWorld world_;
 
     BackgroundPlanes planes_;
-    ShadowBall ball_;
-
-    std::vector<BoxObject> objects_;
-
-    // 完整阴影平台（稳定绑定）
-    std::vector<ShadowPoly> shadowPlatforms_;
-
-    // shadow mesh (render hulls)
-    GLuint shadowVao_ = 0, shadowVbo_ = 0;
+    BoxMesh boxMesh_;
+    static constexpr std::uint64_t kNoVersion = ~0ull;
+    std::uint64_t uploadedObjectsVersion_ = kNoVersion;
+    BallMesh ballMesh_;
+
+    // shadow mesh (render hulls)：world_.hullsVersion() 变了才重写；
+    // 顶点流是 ring buffer，每次写下一个 slice，画的时候从 shadowFirst_ 开始
+    GLuint shadowVao_ = 0;
+    StreamBuffer shadowStream_;
+    GLuint shadowAttachedVbo_ = 0;   // VAO 当前指向的 buffer（persistent 路径扩容会换 buffer）
+    GLint shadowFirst_ = 0;
     GLsizei shadowVertCount_ = 0;
+    std::uint64_t uploadedHullsVersion_ = kNoVersion;
+    ShadowRebuildStats shadowStats_;
+    bool meshUploaded_ = false;
+    bool gpuShadowProjection_ = true;
+    ShadowComposite shadowComposite_ = ShadowComposite::MaskFbo;
+    bool shadowScissor_ = true;
 
-    glm::vec2 spawnBall_{-10.0f, 7.0f};
-    glm::vec3 spawnLight_{-6.0f, 10.0f, 12.0f};
     // shadow mask FBO (avoid darker overlap)
     GLuint shadowMaskFbo_ = 0;
     GLuint shadowMaskTex_ = 0;
+    int maskDivisor_ = 1;
+    int maskWidth_ = 1280, maskHeight_ = 720;
 
     void recreateShadowMaskResources();
     void destroyShadowMaskResources();
 
-    void resetLevel();
-    void initSceneObjects();
-
-    void rebuildShadowPlatforms();
-    void uploadShadowMeshFromHulls();
-
-    // geom helpers
-    static std::vector<glm::vec2> convexHull(std::vector<glm::vec2> pts);
-    static void xRange(const std::vector<glm::vec2>& poly, float& outMinX, float& outMaxX);
-    static bool topYAtX(const std::vector<glm::vec2>& poly, float x, float& outYTop);
-
-    // sticky support logic
-    void dropBallIfOutOfLight();
-    void stickBallToSupportAfterLightMove();
-    const ShadowPoly* findPlatformByObjectId(int objectId) const;
+    void attachShadowStream();
+    void drawShadowCasters();
+    void uploadShadowMeshFromHulls(const HullVertsView& platforms, std::uint64_t version);
+    void uploadBoxInstances(const std::vector<BoxObject>& objects, std::uint64_t version);
+    void renderFrame(const RenderSnapshot& prev, const RenderSnapshot& cur,
+                     const LightSource& simLight, const Camera& simCamera, float ballRadius, float alpha);
 };
 
-#endif // SCENE_HPP
\ No newline at end of file
+#endif // SCENE_HPP
@@ -3,28 +3,67 @@ out vec4 FragColor;
 
 in vec3 vWorldPos;
 
-uniform int uMode = 1; // 0 ball, 1 base, 5 mask, 6 composite
+uniform int uMode = 1; // 0 ball, 1 base, 5 mask, 6 composite, 7 stencil composite
 
 uniform vec3 uColor  = vec3(0.65, 0.50, 0.32);   // wall/floor base
 uniform vec4 uColor4 = vec4(0.10, 0.07, 0.05, 1); // ball/shadow color
 
 uniform int  uUseLighting = 1;
-uniform vec2  uLightCenter = vec2(0.0);
-uniform float uLightRadius = 10.0;
-uniform float uSoftness    = 2.0;
 uniform float uAmbient     = 0.45;
 
-uniform vec2 uResolution = vec2(1280, 720);
 uniform sampler2D uShadowMask;
+uniform int uMaskUpsample = 0;   // mask 比屏幕小时：0 双线性，1 edge-aware（4 tap 后把边重新收紧）
+
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProj;
+    vec4 uViewPos;      // xyz
+    vec4 uLightPos;     // xyz
+    vec4 uLightDir;     // xyz
+    vec4 uLightColor;   // rgb
+    vec4 uFootprint;    // xy center, z radius, w softness
+    vec4 uLightCone;    // x innerCut, y outerCut
+    vec4 uResolution;   // xy size, zw 1/size
+};
 
 float safeLightFactor(vec2 wallXY) {
-    if (uLightRadius <= 1e-4 || uSoftness <= 1e-4) return 0.0;
-    float d = distance(wallXY, uLightCenter);
-    float edge0 = uLightRadius;
-    float edge1 = max(uLightRadius - uSoftness, 0.0);
+    vec2  lightCenter = uFootprint.xy;
+    float lightRadius = uFootprint.z;
+    float softness    = uFootprint.w;
+    if (lightRadius <= 1e-4 || softness <= 1e-4) return 0.0;
+    float d = distance(wallXY, lightCenter);
+    float edge0 = lightRadius;
+    float edge1 = max(lightRadius - softness, 0.0);
     return smoothstep(edge0, edge1, d); // inside=1 outside=0
 }
 
+// 低分辨率 mask 双线性放大后边缘会糊成 scale 倍宽；
+// 在 2x2 邻域有明显落差的地方，用 smoothstep 把过渡带收回到大约一个屏幕像素。
+// 光圈本身的软边（邻域落差小）保持双线性结果。
+float upsampleMaskEdgeAware(vec2 uv) {
+    ivec2 size = textureSize(uShadowMask, 0);
+    vec2  st = uv * vec2(size) - 0.5;
+    ivec2 i0 = ivec2(floor(st));
+    vec2  f  = st - floor(st);
+
+    ivec2 hi = size - 1;
+    float a = texelFetch(uShadowMask, clamp(i0,               ivec2(0), hi), 0).r;
+    float b = texelFetch(uShadowMask, clamp(i0 + ivec2(1, 0), ivec2(0), hi), 0).r;
+    float c = texelFetch(uShadowMask, clamp(i0 + ivec2(0, 1), ivec2(0), hi), 0).r;
+    float d = texelFetch(uShadowMask, clamp(i0 + ivec2(1, 1), ivec2(0), hi), 0).r;
+
+    float m  = mix(mix(a, b, f.x), mix(c, d, f.x), f.y);
+    float lo = min(min(a, b), min(c, d));
+    float up = max(max(a, b), max(c, d));
+    float range = up - lo;
+    if (range < 0.1) return m;
+
+    // 过渡带宽度 ≈ 一个屏幕像素 / 一个 mask texel
+    float k = 0.5 * clamp(float(size.x) * uResolution.z, 0.0, 1.0);
+    float t = smoothstep(0.5 - k, 0.5 + k, (m - lo) / range);
+    return mix(lo, up, t);
+}
+
 void main() {
     vec2 wallXY = vWorldPos.xy;
     float lf = safeLightFactor(wallXY);
@@ -40,9 +79,14 @@ void main() {
         return;
     }
 
+    if (uMode == 7) { // stencil composite：stencil 已圈出阴影，这里只乘光圈软边（与 mode 5 的 mask 值一致）
+        FragColor = vec4(uColor4.rgb, uColor4.a * 0.90 * lf);
+        return;
+    }
+
     if (uMode == 6) { // composite from mask
-        vec2 uv = gl_FragCoord.xy / uResolution;
-        float m = texture(uShadowMask, uv).r;
+        vec2 uv = gl_FragCoord.xy * uResolution.zw;   // mask 尺寸无关：始终覆盖整个屏幕
+        float m = (uMaskUpsample == 1) ? upsampleMaskEdgeAware(uv) : texture(uShadowMask, uv).r;
         FragColor = vec4(uColor4.rgb, uColor4.a * m);
         return;
     }
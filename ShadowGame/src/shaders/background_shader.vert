@@ -2,8 +2,18 @@
 layout(location = 0) in vec3 aPos;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
+
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProj;
+    vec4 uViewPos;      // xyz
+    vec4 uLightPos;     // xyz
+    vec4 uLightDir;     // xyz
+    vec4 uLightColor;   // rgb
+    vec4 uFootprint;    // xy center, z radius, w softness
+    vec4 uLightCone;    // x innerCut, y outerCut
+    vec4 uResolution;   // xy size, zw 1/size
+};
 
 out vec3 vWorldPos;
 
@@ -1,15 +1,19 @@
 #version 330 core
 in vec3 vPos;
 in vec3 vNrm;
-
-uniform vec3 uColor;
-
-uniform vec3 uViewPos;
-uniform vec3 uLightPos;
-uniform vec3 uLightColor;
-uniform vec3 uLightDir;
-uniform float uInnerCut;
-uniform float uOuterCut;
+flat in vec3 vColor;
+
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProj;
+    vec4 uViewPos;      // xyz
+    vec4 uLightPos;     // xyz
+    vec4 uLightDir;     // xyz
+    vec4 uLightColor;   // rgb
+    vec4 uFootprint;    // xy center, z radius, w softness
+    vec4 uLightCone;    // x innerCut, y outerCut
+    vec4 uResolution;   // xy size, zw 1/size
+};
 
 uniform float uEnvAmbient;
 
@@ -17,19 +21,22 @@ out vec4 FragColor;
 
 void main() {
     vec3 N = normalize(vNrm);
-    vec3 L = normalize(uLightPos - vPos);
+    vec3 lightPos = uLightPos.xyz;
+    vec3 L = normalize(lightPos - vPos);
 
     float diff = max(dot(N, L), 0.0);
 
-    float theta = dot(normalize(-uLightDir), L);
-    float eps = max(uInnerCut - uOuterCut, 1e-4);
-    float spot = clamp((theta - uOuterCut) / eps, 0.0, 1.0);
+    float innerCut = uLightCone.x;
+    float outerCut = uLightCone.y;
+    float theta = dot(normalize(-uLightDir.xyz), L);
+    float eps = max(innerCut - outerCut, 1e-4);
+    float spot = clamp((theta - outerCut) / eps, 0.0, 1.0);
 
-    float dist = length(uLightPos - vPos);
+    float dist = length(lightPos - vPos);
     float atten = 1.0 / (1.0 + 0.10 * dist + 0.018 * dist * dist);
 
-    vec3 ambient = uEnvAmbient * uColor;
-    vec3 lit = (ambient + spot * atten * diff * uLightColor) * uColor;
+    vec3 ambient = uEnvAmbient * vColor;
+    vec3 lit = (ambient + spot * atten * diff * uLightColor.rgb) * vColor;
 
     FragColor = vec4(lit, 1.0);
 }
\ No newline at end of file
@@ -2,16 +2,32 @@
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNrm;
 
-uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
+// per-instance（BoxInstance）：盒子只有平移+缩放
+layout(location = 2) in vec3 iCenter;
+layout(location = 3) in vec3 iScale;
+layout(location = 4) in vec3 iInvScale;   // 法线变换 diag(1/scale)，CPU 端算好
+layout(location = 5) in vec3 iColor;
+
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProj;
+    vec4 uViewPos;      // xyz
+    vec4 uLightPos;     // xyz
+    vec4 uLightDir;     // xyz
+    vec4 uLightColor;   // rgb
+    vec4 uFootprint;    // xy center, z radius, w softness
+    vec4 uLightCone;    // x innerCut, y outerCut
+    vec4 uResolution;   // xy size, zw 1/size
+};
 
 out vec3 vPos;
 out vec3 vNrm;
+flat out vec3 vColor;
 
 void main() {
-    vec4 wp = uModel * vec4(aPos, 1.0);
-    vPos = wp.xyz;
-    vNrm = mat3(transpose(inverse(uModel))) * aNrm;
-    gl_Position = uProj * uView * wp;
-}
\ No newline at end of file
+    vec3 wp = iCenter + aPos * iScale;
+    vPos = wp;
+    vNrm = aNrm * iInvScale;
+    vColor = iColor;
+    gl_Position = uProj * uView * vec4(wp, 1.0);
+}
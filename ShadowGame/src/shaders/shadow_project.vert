@@ -0,0 +1,38 @@
+#version 330 core
+// 阴影 mask 的 GPU 投影：盒子 mesh + 实例数据都是静态的，
+// 每个顶点沿点光源射线投到墙面 z=0，每帧只有 uLightPos 在变。
+// 投影后各个面的并集就是剪影（mask pass 用 GL_MAX 混合，重叠无所谓）。
+// 片元用 background_shader.frag 的 mode 5。
+layout(location = 0) in vec3 aPos;
+
+// per-instance（BoxInstance），与 object_shader.vert 同一套 attribute
+layout(location = 2) in vec3 iCenter;
+layout(location = 3) in vec3 iScale;
+
+layout(std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProj;
+    vec4 uViewPos;      // xyz
+    vec4 uLightPos;     // xyz
+    vec4 uLightDir;     // xyz
+    vec4 uLightColor;   // rgb
+    vec4 uFootprint;    // xy center, z radius, w softness
+    vec4 uLightCone;    // x innerCut, y outerCut
+    vec4 uResolution;   // xy size, zw 1/size
+};
+
+out vec3 vWorldPos;
+
+void main() {
+    vec3 p = iCenter + aPos * iScale;
+    vec3 L = uLightPos.xyz;
+
+    // 与 geom::projectToWallZ0 相同：hit = L + t (p - L)，t = L.z / (L.z - p.z)
+    // 光源不在顶点上方时夹住分母，点被推到很远（CPU 那边这种情况走通用凸包）
+    float denom = max(L.z - p.z, 1e-4);
+    vec2 hit = L.xy + (p.xy - L.xy) * (L.z / denom);
+
+    vec4 wp = vec4(hit, 0.02, 1.0);
+    vWorldPos = wp.xyz;
+    gl_Position = uProj * uView * wp;
+}
@@ -8,7 +8,8 @@
 // ============================================================================
 
 #include "shadow.hpp"
-#include "object.hpp" // Shader lives here in your project
+#include "collision.hpp"
+#include "shadow_simd.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -18,21 +19,12 @@
 static float dot2(const glm::vec2& a, const glm::vec2& b) { return a.x * b.x + a.y * b.y; }
 static float len2(const glm::vec2& v) { return dot2(v, v); }
 
-static glm::vec2 closestPointOnSegment(const glm::vec2& p, const glm::vec2& a, const glm::vec2& b) {
-    const glm::vec2 ab = b - a;
-    const float ab2 = dot2(ab, ab);
-    if (ab2 < 1e-10f) return a;
-    float t = dot2(p - a, ab) / ab2;
-    t = std::clamp(t, 0.0f, 1.0f);
-    return a + t * ab;
-}
-
 // CCW convex: inside if for all edges, point is on left side (cross >= 0)
-bool ShadowBall::isInsideConvexCCW(const std::vector<glm::vec2>& poly, const glm::vec2& p) {
-    if (poly.size() < 3) return false;
-    for (size_t i = 0; i < poly.size(); ++i) {
+bool ShadowBall::isInsideConvexCCW(const glm::vec2* poly, int n, const glm::vec2& p) {
+    if (n < 3) return false;
+    for (int i = 0; i < n; ++i) {
         const glm::vec2 a = poly[i];
-        const glm::vec2 b = poly[(i + 1) % poly.size()];
+        const glm::vec2 b = poly[(i + 1) % n];
         const glm::vec2 ab = b - a;
         const glm::vec2 ap = p - a;
         const float cross = ab.x * ap.y - ab.y * ap.x;
@@ -41,59 +33,20 @@ bool ShadowBall::isInsideConvexCCW(const std::vector<glm::vec2>& poly, const glm
     return true;
 }
 
-ShadowBall::ShadowBall() {
-    const int segments = 48;
-    std::vector<glm::vec3> verts;
-    verts.reserve(segments + 2);
-
-    verts.push_back(glm::vec3(0.0f, 0.0f, 0.03f));
-    for (int i = 0; i <= segments; ++i) {
-        const float a = (float)i / (float)segments * 2.0f * 3.1415926f;
-        verts.push_back(glm::vec3(std::cos(a), std::sin(a), 0.03f));
-    }
-    count_ = (GLsizei)verts.size();
-
-    glGenVertexArrays(1, &vao_);
-    glGenBuffers(1, &vbo_);
-    glBindVertexArray(vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(verts.size() * sizeof(glm::vec3)), verts.data(), GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-    glBindVertexArray(0);
-}
-
-ShadowBall::~ShadowBall() {
-    if (vbo_) glDeleteBuffers(1, &vbo_);
-    if (vao_) glDeleteVertexArrays(1, &vao_);
-}
-
-bool ShadowBall::jumpPressedEdge(GLFWwindow* window) const {
-    static bool last = false;
-    const bool now = (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) ||
-                     (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS);
-    const bool edge = now && !last;
-    last = now;
+bool ShadowBall::jumpPressedEdge(const InputState& in) {
+    const bool now = in.held(kInputJump);
+    const bool edge = now && !jumpHeldLast_;
+    jumpHeldLast_ = now;
     return edge;
 }
 
-void ShadowBall::xRange(const std::vector<glm::vec2>& poly, float& outMinX, float& outMaxX) {
-    outMinX = std::numeric_limits<float>::infinity();
-    outMaxX = -std::numeric_limits<float>::infinity();
-    for (const auto& v : poly) {
-        outMinX = std::min(outMinX, v.x);
-        outMaxX = std::max(outMaxX, v.x);
-    }
-}
-
-bool ShadowBall::topYAtX(const std::vector<glm::vec2>& poly, float x, float& outYTop) {
+bool ShadowBall::topYAtX(const glm::vec2* poly, int n, float x, float& outYTop) {
     float best = -std::numeric_limits<float>::infinity();
     bool any = false;
 
-    for (size_t i = 0; i < poly.size(); ++i) {
+    for (int i = 0; i < n; ++i) {
         const glm::vec2 a = poly[i];
-        const glm::vec2 b = poly[(i + 1) % poly.size()];
+        const glm::vec2 b = poly[(i + 1) % n];
 
         const float minx = std::min(a.x, b.x);
         const float maxx = std::max(a.x, b.x);
@@ -130,108 +83,64 @@ bool ShadowBall::topYAtX(const std::vector<glm::vec2>& poly, float x, float& out
 //      * ceiling edges: normal.y < 0 (typically top edge outward normal points downward in CCW)
 //    (we intentionally do NOT treat bottom edges as walls -> removes "air wall" on lower boundary)
 // ---------------------------------------------------------------------------
-void ShadowBall::preventEnterSideWalls(const std::vector<glm::vec2>& poly,
+void ShadowBall::preventEnterSideWalls(const HullView& poly,
                                        const glm::vec2& prevPos,
                                        glm::vec2& pos,
                                        glm::vec2& vel,
                                        float r) {
-    if (poly.size() < 3) return;
+    if (!poly.valid()) return;
+
+    // 粗筛：前后两帧的圆都碰不到包围圆，就不可能压到任何边
+    {
+        const float reach = poly.radius + r;
+        const glm::vec2 d0 = prevPos - poly.center;
+        const glm::vec2 d1 = pos - poly.center;
+        if (len2(d0) > reach * reach && len2(d1) > reach * reach) return;
+    }
 
     const float skin = 1e-3f;
 
     // Only handle "outside -> penetrated"
     // A robust gate: previous frame circle not intersecting any relevant edge, now intersecting.
-    auto edgeCirclePenetration = [&](const glm::vec2& center,
-                                    const glm::vec2& a,
-                                    const glm::vec2& b,
-                                    glm::vec2& outN,
-                                    float& outPen) -> bool {
-        const glm::vec2 e = b - a;
-        if (len2(e) < 1e-10f) return false;
-
-        // CCW outward normal (right normal)
-        glm::vec2 n(e.y, -e.x);
-        const float n2 = len2(n);
-        if (n2 < 1e-10f) return false;
-        n *= 1.0f / std::sqrt(n2);
-
-        const bool isSide = (std::fabs(n.x) > 0.6f);
-        const bool isCeil = (n.y < -0.6f); // outward points downward
-        if (!isSide && !isCeil) return false;
-
-        // Don't block ceiling unless moving upward (prevents weird "air ceilings" when falling nearby)
-        if (isCeil && vel.y <= 0.0f) return false;
-
-        const glm::vec2 c = closestPointOnSegment(center, a, b);
-        const glm::vec2 d = center - c;
-        const float d2 = len2(d);
-        if (d2 >= r * r) return false;
-
-        const float dist = std::sqrt(std::max(d2, 1e-12f));
-        // normal points from boundary -> center
-        outN = (dist > 1e-6f) ? (d * (1.0f / dist)) : n;
-        outPen = (r - dist);
-        return outPen > 0.0f;
-    };
-
-    auto penetratesAnyRelevantEdge = [&](const glm::vec2& center) -> bool {
-        for (size_t i = 0; i < poly.size(); ++i) {
-            const glm::vec2 a = poly[i];
-            const glm::vec2 b = poly[(i + 1) % poly.size()];
-            glm::vec2 n;
-            float pen = 0.0f;
-            if (edgeCirclePenetration(center, a, b, n, pen)) return true;
-        }
-        return false;
+    // 哪些边算墙（side / ceiling）在重建时已经分类成 mask；ceiling 只在往上走时挡，
+    // vel 在下面的迭代里会被改，所以每次都按当前 vel.y 取 mask
+    auto deepest = [&](const glm::vec2& center) {
+        return geom::deepestEdgePenetration(poly, vel.y > 0.0f ? poly.wallMaskRising : poly.wallMaskFalling, center, r);
     };
 
-    const bool prevPen = penetratesAnyRelevantEdge(prevPos);
-    const bool nowPen  = penetratesAnyRelevantEdge(pos);
+    const bool prevPen = deepest(prevPos).edge >= 0;
+    const bool nowPen  = deepest(pos).edge >= 0;
     if (prevPen || !nowPen) return;
 
     // Resolve with a few iterations to handle corners
     for (int iter = 0; iter < 4; ++iter) {
-        float bestPen = 0.0f;
-        glm::vec2 bestN(0.0f);
-
-        for (size_t i = 0; i < poly.size(); ++i) {
-            const glm::vec2 a = poly[i];
-            const glm::vec2 b = poly[(i + 1) % poly.size()];
-            glm::vec2 n;
-            float pen = 0.0f;
-            if (!edgeCirclePenetration(pos, a, b, n, pen)) continue;
-
-            if (pen > bestPen) {
-                bestPen = pen;
-                bestN = n;
-            }
-        }
-
-        if (bestPen <= 0.0f) break;
+        const geom::EdgePenetration hit = deepest(pos);
+        if (hit.edge < 0) break;
 
         // push out
-        pos += bestN * (bestPen + skin);
+        pos += hit.normal * (hit.depth + skin);
 
         // remove velocity component into obstacle
-        const float vn = dot2(vel, bestN);
-        if (vn < 0.0f) vel -= bestN * vn;
+        const float vn = dot2(vel, hit.normal);
+        if (vn < 0.0f) vel -= hit.normal * vn;
 
-        if (!penetratesAnyRelevantEdge(pos)) break;
+        if (deepest(pos).edge < 0) break;
     }
 }
 
-void ShadowBall::updatePhysics(GLFWwindow* window, float dt,
-                               const std::vector<ShadowPoly>& platforms,
+void ShadowBall::updatePhysics(const InputState& in, float dt,
+                               const HullPool& platforms,
+                               const HullGrid& grid,
                                const glm::vec2& lightCenter,
                                float lightRadius) {
     float dir = 0.0f;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) dir -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) dir += 1.0f;
+    if (in.held(kInputLeft))  dir -= 1.0f;
+    if (in.held(kInputRight)) dir += 1.0f;
     vel.x = dir * moveSpeed;
 
     vel.y += gravity * dt;
 
-    if (grounded_ && jumpPressedEdge(window)) {
+    if (grounded_ && jumpPressedEdge(in)) {
         vel.y = jumpSpeed;
         grounded_ = false;
         supportObjectId_ = -1;
@@ -255,17 +164,14 @@ void ShadowBall::updatePhysics(GLFWwindow* window, float dt,
     // and has a valid top, otherwise drop (walk-off edge works).
     // -----------------------------------------------------------------------
     if (grounded_ && supportObjectId_ >= 0) {
-        const ShadowPoly* sp = nullptr;
-        for (const auto& p : platforms) {
-            if (p.objectId == supportObjectId_) { sp = &p; break; }
-        }
-        if (!sp || sp->hull.size() < 3) {
+        const int slot = platforms.slotOf(supportObjectId_);
+        if (slot < 0 || !platforms.valid(slot)) {
             drop();
             return;
         }
 
-        float minX, maxX;
-        xRange(sp->hull, minX, maxX);
+        const float minX = platforms.minX(slot);
+        const float maxX = platforms.maxX(slot);
 
         // ✅ overlap test (NOT center test)
         if (pos.x + radius < minX || pos.x - radius > maxX) {
@@ -277,7 +183,7 @@ void ShadowBall::updatePhysics(GLFWwindow* window, float dt,
         const float xQuery = std::clamp(pos.x, minX, maxX);
 
         float yTop = 0.0f;
-        if (!topYAtX(sp->hull, xQuery, yTop)) {
+        if (!topYAtX(platforms.verts(slot), platforms.count(slot), xQuery, yTop)) {
             drop();
             return;
         }
@@ -288,91 +194,99 @@ void ShadowBall::updatePhysics(GLFWwindow* window, float dt,
     }
 
     // -----------------------------------------------------------------------
-    // Air: prevent entering shadow through side / ceiling
-    // (do not run while grounded, otherwise it blocks walk-off)
+    // Air: swept circle vs hulls (continuous)
+    //  - 从 prevPos 出发沿本 tick 位移求最早接触（TOI），接触点解析求出
+    //  - side / ceiling：停在接触点，去掉法向速度，用剩余时间继续积分
+    //  - top（只在下落时）：落地，贴到 topYAtX，落点必须在光圈内
     // -----------------------------------------------------------------------
     if (!grounded_) {
-        for (const auto& sp : platforms) {
-            preventEnterSideWalls(sp.hull, prevPos, pos, vel, radius);
-        }
-    }
-
-    // -----------------------------------------------------------------------
-    // Landing (one-way): falling only, choose highest platform under x-overlap
-    // -----------------------------------------------------------------------
-    if (!grounded_ && vel.y <= 0.0f) {
-        const float prevBottom = prevPos.y - radius;
-        const float newBottom  = pos.y - radius;
-
-        int bestObj = -1;
-        float bestYTop = -std::numeric_limits<float>::infinity();
-
-        for (const auto& sp : platforms) {
-            if (sp.hull.size() < 3) continue;
-
-            float minX, maxX;
-            xRange(sp.hull, minX, maxX);
-
-            // ✅ overlap test (NOT center test)
-            if (pos.x + radius < minX || pos.x - radius > maxX) continue;
-
-            const float xQuery = std::clamp(pos.x, minX, maxX);
-
-            float yTop = 0.0f;
-            if (!topYAtX(sp.hull, xQuery, yTop)) continue;
-
-            const float eps = 1e-3f;
-            const bool crossed = (prevBottom >= yTop - eps) && (newBottom <= yTop + eps);
-            if (!crossed) continue;
-
-            // landing must be in light (circle test)
-            const glm::vec2 landingCenter(pos.x, yTop + radius);
-            if (glm::distance(landingCenter, lightCenter) + radius > lightRadius) continue;
+        const float skin = 1e-3f;
+        glm::vec2 p = prevPos;
+        float remaining = dt;
+
+        // 落点不在光圈内的顶面：本 tick 内当作不存在（一条条记下来，避免反复命中）
+        // 每次迭代最多记一个，容量与迭代上限相同就永远记得下
+        constexpr int kMaxSweepIters = 6;
+        int skipTop[kMaxSweepIters];
+        int skipCount = 0;
+        bool settled = false;
+
+        for (int iter = 0; iter < kMaxSweepIters && remaining > 0.0f; ++iter) {
+            const glm::vec2 d = vel * remaining;
+
+            unsigned kinds = collision::kEdgeSide;
+            kinds |= (vel.y > 0.0f) ? collision::kEdgeCeiling : collision::kEdgeTop;
+
+            collision::SweepHit hit;
+            const glm::vec2 lo = glm::min(p, p + d) - glm::vec2(radius);
+            const glm::vec2 hi = glm::max(p, p + d) + glm::vec2(radius);
+            grid.query(lo.x, lo.y, hi.x, hi.y, [&](int slot) {
+                unsigned k = kinds;
+                for (int j = 0; j < skipCount; ++j) if (skipTop[j] == slot) k &= ~collision::kEdgeTop;
+                collision::sweepCircleHull(platforms.view(slot), slot, p, d, radius, k, hit);
+            });
+
+            if (hit.slot < 0) {
+                p += d;
+                settled = true;
+                break;
+            }
 
-            if (yTop > bestYTop) {
-                bestYTop = yTop;
-                bestObj = sp.objectId;
+            const glm::vec2 contact = p + d * hit.t;
+
+            if (hit.kind & collision::kEdgeTop) {
+                const float minX = platforms.minX(hit.slot);
+                const float maxX = platforms.maxX(hit.slot);
+                const float xQuery = std::clamp(contact.x, minX, maxX);
+
+                float yTop = 0.0f;
+                const bool hasTop = topYAtX(platforms.verts(hit.slot), platforms.count(hit.slot), xQuery, yTop);
+
+                // landing must be in light (circle test)
+                const glm::vec2 landingCenter(contact.x, yTop + radius);
+                if (hasTop && glm::distance(landingCenter, lightCenter) + radius <= lightRadius) {
+                    p = landingCenter;
+                    vel.y = 0.0f;
+                    grounded_ = true;
+                    supportObjectId_ = platforms.objectId(hit.slot);
+                    settled = true;
+                    break;
+                }
+
+                // 不能站：穿过这块平台的顶面，重新扫这一段
+                skipTop[skipCount++] = hit.slot;
+                continue;
             }
-        }
 
-        if (bestObj >= 0) {
-            pos.y = bestYTop + radius;
-            vel.y = 0.0f;
-            grounded_ = true;
-            supportObjectId_ = bestObj;
+            // side / ceiling：停在接触点（留 skin），滑动
+            p = contact + hit.normal * skin;
+            const float vn = dot2(vel, hit.normal);
+            if (vn < 0.0f) vel -= hit.normal * vn;
+            remaining *= (1.0f - hit.t);
         }
+
+        // 迭代用完还有剩余位移（夹角里来回碰）：直接走完，交给下面的离散兜底
+        if (!settled && remaining > 0.0f) p += vel * remaining;
+        pos = p;
+    }
+
+    // 离散兜底：光源移动会让 hull 本身扫过球，扫掠（假设 hull 静止）看不到这种情况
+    if (!grounded_) {
+        const glm::vec2 lo = glm::min(prevPos, pos) - glm::vec2(2.0f * radius);
+        const glm::vec2 hi = glm::max(prevPos, pos) + glm::vec2(2.0f * radius);
+        grid.query(lo.x, lo.y, hi.x, hi.y, [&](int slot) {
+            preventEnterSideWalls(platforms.view(slot), prevPos, pos, vel, radius);
+        });
     }
 
     // supportU update
     if (grounded_ && supportObjectId_ >= 0) {
-        const ShadowPoly* sp = nullptr;
-        for (const auto& p : platforms) {
-            if (p.objectId == supportObjectId_) { sp = &p; break; }
-        }
-        if (sp && sp->hull.size() >= 3) {
-            float minX, maxX;
-            xRange(sp->hull, minX, maxX);
+        const int slot = platforms.slotOf(supportObjectId_);
+        if (slot >= 0 && platforms.valid(slot)) {
+            const float minX = platforms.minX(slot);
+            const float maxX = platforms.maxX(slot);
             const float w = std::max(maxX - minX, 1e-5f);
             supportU_ = std::clamp((pos.x - minX) / w, 0.0f, 1.0f);
         }
     }
 }
-
-void ShadowBall::draw(const Shader& shader, const glm::mat4& view, const glm::mat4& proj) const {
-    shader.use();
-
-    glm::mat4 m(1.0f);
-    m = glm::translate(m, glm::vec3(pos.x, pos.y, 0.0f));
-    m = glm::scale(m, glm::vec3(radius, radius, 1.0f));
-
-    shader.setMat4("uModel", m);
-    shader.setMat4("uView", view);
-    shader.setMat4("uProj", proj);
-
-    shader.setInt("uMode", 0);
-    shader.setVec4("uColor4", glm::vec4(0.90f, 0.20f, 0.20f, 1.0f));
-
-    glBindVertexArray(vao_);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, count_);
-    glBindVertexArray(0);
-}
@@ -2,18 +2,21 @@
 #ifndef SHADOW_HPP
 #define SHADOW_HPP
 
-#include <GL/glew.h>
-#include <GLFW/glfw3.h>
-
 #include <glm/glm.hpp>
 #include <vector>
 
-// ShadowPoly: 用于表示物体的完整阴影（凸包）
-struct ShadowPoly {
-    int objectId = -1;               // 稳定 ID：用 objects_ 下标即可
-    std::vector<glm::vec2> hull;     // 完整阴影（凸包），用于平台/等比移动/物理
+#include "input.hpp"
+#include "hull_grid.hpp"
+#include "hull_pool.hpp" // 完整阴影（凸包）平台：objectId 稳定绑定 objects_ 下标
+
+// 每帧阴影重建统计：rebuilt = 重新投影的 hull 数，reused = 命中缓存的 hull 数
+struct ShadowRebuildStats {
+    int rebuilt = 0;
+    int reused = 0;
+    // 查表剪影与参考凸包不一致的 hull 数（只有 -DSHADOWGAME_VALIDATE_SILHOUETTE=ON 时才会去比）
+    int silhouetteMismatches = 0;
+    bool meshUploaded = false;
 };
-class Shader;
 
 class ShadowBall final {
 public:
@@ -25,12 +28,6 @@ public:
     float jumpSpeed = 15.0f;
     float gravity = -18.0f;
 
-    ShadowBall();
-    ~ShadowBall();
-
-    ShadowBall(const ShadowBall&) = delete;
-    ShadowBall& operator=(const ShadowBall&) = delete;
-
     void reset(const glm::vec2& p) {
         pos = p;
         vel = glm::vec2(0.0f);
@@ -39,8 +36,9 @@ public:
         supportU_ = 0.5f;
     }
 
-    void updatePhysics(GLFWwindow* window, float dt,
-                       const std::vector<ShadowPoly>& platforms,
+    void updatePhysics(const InputState& in, float dt,
+                       const HullPool& platforms,
+                       const HullGrid& grid,
                        const glm::vec2& lightCenter,
                        float lightRadius);
 
@@ -53,29 +51,24 @@ public:
     void forceGrounded(bool g) { grounded_ = g; }
     void drop() { grounded_ = false; supportObjectId_ = -1; supportU_ = 0.0f;}
 
-    void draw(const Shader& shader, const glm::mat4& view, const glm::mat4& proj) const;
+    // 物理内部用的几何小工具，公开出来给 bench 直接计时
+    static bool topYAtX(const glm::vec2* poly, int n, float x, float& outYTop);
+    static bool isInsideConvexCCW(const glm::vec2* poly, int n, const glm::vec2& p);
+    // 离散兜底：只处理“上一 tick 没压到、这一 tick 压进 side / ceiling 边”
+    static void preventEnterSideWalls(const HullView& poly,
+                                      const glm::vec2& prevPos,
+                                      glm::vec2& pos,
+                                      glm::vec2& vel,
+                                      float radius);
 
 private:
     bool grounded_ = false;
     int supportObjectId_ = -1;
     float supportU_ = 0.5f;
 
-    GLuint vao_ = 0, vbo_ = 0;
-    GLsizei count_ = 0;
-
-    bool jumpPressedEdge(GLFWwindow* window) const;
-
-    static void xRange(const std::vector<glm::vec2>& poly, float& outMinX, float& outMaxX);
-    static bool topYAtX(const std::vector<glm::vec2>& poly, float x, float& outYTop);
-
-    static bool isInsideConvexCCW(const std::vector<glm::vec2>& poly, const glm::vec2& p);
-    // src/shadow.hpp (replace the private helper declaration)
-    static void preventEnterSideWalls(const std::vector<glm::vec2>& poly,
-                                    const glm::vec2& prevPos,
-                                    glm::vec2& pos,
-                                    glm::vec2& vel,
-                                    float radius);
-
+    // 上一 tick 跳跃键是否按住（边沿检测用；每个球各自一份，回放才可复现）
+    bool jumpHeldLast_ = false;
+    bool jumpPressedEdge(const InputState& in);
 };
 
 #endif
@@ -0,0 +1,187 @@
+// ============================================================================
+// File: src/shadow_geom.cpp
+// 剪影表：对每个光源区域，取“朝光面”与“背光面”之间的棱，
+// 按朝光面外法线方向的 CCW 顺序串成环 —— 从光源看是 CCW，投到 z=0 后仍是 CCW。
+// ============================================================================
+#include "shadow_geom.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace geom {
+namespace {
+
+struct SilhouetteEntry {
+    std::uint8_t count = 0;
+    std::uint8_t corner[kMaxSilhouetteVerts] = {};
+};
+
+// 6 个面：轴、朝向、从外侧看 CCW 的 4 个角点
+struct BoxFace {
+    int axis;
+    int sign;
+    int corner[4];
+};
+
+constexpr BoxFace kFaces[6] = {
+    {0, +1, {1, 3, 7, 5}},
+    {0, -1, {0, 4, 6, 2}},
+    {1, +1, {2, 6, 7, 3}},
+    {1, -1, {0, 1, 5, 4}},
+    {2, +1, {4, 5, 7, 6}},
+    {2, -1, {0, 2, 3, 1}},
+};
+
+constexpr bool faceHasEdge(const BoxFace& f, int a, int b) {
+    bool hasA = false, hasB = false;
+    for (int i = 0; i < 4; ++i) {
+        hasA = hasA || f.corner[i] == a;
+        hasB = hasB || f.corner[i] == b;
+    }
+    return hasA && hasB;
+}
+
+// region[axis]: 0 = 光源在 min 一侧，1 = 在范围内，2 = 在 max 一侧
+constexpr bool faceTowardLight(const BoxFace& f, const int region[3]) {
+    return region[f.axis] == (f.sign > 0 ? 2 : 0);
+}
+
+constexpr SilhouetteEntry buildEntry(int rx, int ry, int rz) {
+    const int region[3] = {rx, ry, rz};
+
+    int from[12] = {};
+    int to[12] = {};
+    int edgeCount = 0;
+
+    for (const BoxFace& f : kFaces) {
+        if (!faceTowardLight(f, region)) continue;
+        for (int i = 0; i < 4; ++i) {
+            const int a = f.corner[i];
+            const int b = f.corner[(i + 1) % 4];
+            // 相邻面背光 -> 这条棱在剪影上
+            for (const BoxFace& g : kFaces) {
+                if (&g == &f || !faceHasEdge(g, a, b)) continue;
+                if (!faceTowardLight(g, region)) {
+                    from[edgeCount] = a;
+                    to[edgeCount] = b;
+                    ++edgeCount;
+                }
+            }
+        }
+    }
+
+    SilhouetteEntry e;
+    if (edgeCount < 3 || edgeCount > kMaxSilhouetteVerts) return e; // 光源在盒内：无剪影
+
+    // 首尾相接串成环
+    int cur = 0;
+    for (int k = 0; k < edgeCount; ++k) {
+        e.corner[k] = static_cast<std::uint8_t>(from[cur]);
+        for (int j = 0; j < edgeCount; ++j) {
+            if (from[j] == to[cur]) { cur = j; break; }
+        }
+    }
+    e.count = static_cast<std::uint8_t>(edgeCount);
+    return e;
+}
+
+constexpr std::array<SilhouetteEntry, 27> buildTable() {
+    std::array<SilhouetteEntry, 27> t{};
+    for (int rz = 0; rz < 3; ++rz)
+        for (int ry = 0; ry < 3; ++ry)
+            for (int rx = 0; rx < 3; ++rx)
+                t[rx + 3 * ry + 9 * rz] = buildEntry(rx, ry, rz);
+    return t;
+}
+
+constexpr std::array<SilhouetteEntry, 27> kSilhouetteTable = buildTable();
+
+static_assert(kSilhouetteTable[13].count == 0, "light inside box has no silhouette");
+static_assert(kSilhouetteTable[22].count == 4, "light straight above +z face -> that face's rim");
+static_assert(kSilhouetteTable[21].count == 6, "edge region -> hexagon");
+static_assert(kSilhouetteTable[26].count == 6, "corner region -> hexagon");
+
+inline int regionOf(float l, float mn, float mx) {
+    return (l < mn) ? 0 : ((l > mx) ? 2 : 1);
+}
+
+inline float cross2(const glm::vec2& o, const glm::vec2& a, const glm::vec2& b) {
+    const glm::vec2 oa = a - o;
+    const glm::vec2 ob = b - o;
+    return oa.x * ob.y - oa.y * ob.x;
+}
+
+} // namespace
+
+glm::vec2 projectToWallZ0(const glm::vec3& lightPos, const glm::vec3& p) {
+    const float denom = (p.z - lightPos.z);
+    if (std::fabs(denom) < 1e-6f) return glm::vec2(p.x, p.y);
+    const float t = (0.0f - lightPos.z) / denom;
+    const glm::vec3 hit = lightPos + t * (p - lightPos);
+    return glm::vec2(hit.x, hit.y);
+}
+
+glm::vec3 boxCorner(const glm::vec3& boxMin, const glm::vec3& boxMax, int corner) {
+    return glm::vec3((corner & 1) ? boxMax.x : boxMin.x,
+                     (corner & 2) ? boxMax.y : boxMin.y,
+                     (corner & 4) ? boxMax.z : boxMin.z);
+}
+
+ProjectedBoxCorners projectBoxCorners(const glm::vec3& lightPos, const glm::vec3& boxMin, const glm::vec3& boxMax) {
+    // 盒子只有两种 z，投影缩放系数只需算两次
+    const float t[2] = {
+        -lightPos.z / (boxMin.z - lightPos.z),
+        -lightPos.z / (boxMax.z - lightPos.z),
+    };
+    ProjectedBoxCorners p;
+    for (int z = 0; z < 2; ++z) {
+        p.x[z][0] = lightPos.x + t[z] * (boxMin.x - lightPos.x);
+        p.x[z][1] = lightPos.x + t[z] * (boxMax.x - lightPos.x);
+        p.y[z][0] = lightPos.y + t[z] * (boxMin.y - lightPos.y);
+        p.y[z][1] = lightPos.y + t[z] * (boxMax.y - lightPos.y);
+    }
+    return p;
+}
+
+int boxSilhouetteOnWall(const glm::vec3& lightPos,
+                        const glm::vec3& boxMin, const glm::vec3& boxMax,
+                        glm::vec2 out[kMaxSilhouetteVerts]) {
+    // 只有整个盒子都在光源下方（z 更小）时，中心投影才保持凸性与朝向
+    if (!(lightPos.z > boxMax.z)) return -1;
+    return silhouetteFromProjected(lightPos, boxMin, boxMax, projectBoxCorners(lightPos, boxMin, boxMax), out);
+}
+
+int silhouetteFromProjected(const glm::vec3& lightPos,
+                            const glm::vec3& boxMin, const glm::vec3& boxMax,
+                            const ProjectedBoxCorners& projected,
+                            glm::vec2 out[kMaxSilhouetteVerts]) {
+    if (!(lightPos.z > boxMax.z)) return -1;
+
+    const int rx = regionOf(lightPos.x, boxMin.x, boxMax.x);
+    const int ry = regionOf(lightPos.y, boxMin.y, boxMax.y);
+    const SilhouetteEntry& e = kSilhouetteTable[(size_t)(rx + 3 * ry + 18)];
+
+    int n = 0;
+    for (int k = 0; k < e.count; ++k) {
+        const int c = e.corner[k];
+        out[n++] = glm::vec2(projected.x[c >> 2][c & 1], projected.y[c >> 2][(c >> 1) & 1]);
+    }
+
+    // 光源贴着区域边界时会出现近似重合/共线的点：与通用凸包一样剔除
+    for (int i = 0; i < n && n >= 3;) {
+        const glm::vec2& prev = out[(i + n - 1) % n];
+        const glm::vec2& next = out[(i + 1) % n];
+        const bool dup = std::fabs(out[i].x - prev.x) < 1e-5f && std::fabs(out[i].y - prev.y) < 1e-5f;
+        if (dup || cross2(prev, out[i], next) <= 0.0f) {
+            for (int j = i; j + 1 < n; ++j) out[j] = out[j + 1];
+            --n;
+            i = 0;
+            continue;
+        }
+        ++i;
+    }
+    return n;
+}
+
+} // namespace geom
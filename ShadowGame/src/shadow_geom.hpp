@@ -0,0 +1,47 @@
+// ============================================================================
+// File: src/shadow_geom.hpp
+// 阴影投影几何：点光源把轴对齐盒子投到墙面 z=0
+// ============================================================================
+#pragma once
+#ifndef SHADOW_GEOM_HPP
+#define SHADOW_GEOM_HPP
+
+#include <glm/glm.hpp>
+
+namespace geom {
+
+// 轴对齐盒子的剪影最多 6 个顶点（光源在棱/角区域时为 6，面区域时为 4）
+constexpr int kMaxSilhouetteVerts = 6;
+
+// project corner to wall z=0 along ray from light
+glm::vec2 projectToWallZ0(const glm::vec3& lightPos, const glm::vec3& p);
+
+// 盒子角点编号：bit0 = x 取 max，bit1 = y 取 max，bit2 = z 取 max
+glm::vec3 boxCorner(const glm::vec3& boxMin, const glm::vec3& boxMax, int corner);
+
+// 盒子 8 个角点投到 z=0 后的样子：z=min / z=max 两个面各是一个轴对齐矩形
+// x[z][s] / y[z][s]：z 面（0 = zMin，1 = zMax）上 s 侧（0 = min，1 = max）的投影坐标
+// 角点 c（编号见 boxCorner）投影 = (x[c>>2][c&1], y[c>>2][(c>>1)&1])
+struct ProjectedBoxCorners {
+    float x[2][2];
+    float y[2][2];
+};
+
+// 标量版投影；要求 lightPos.z 不等于盒子的两个 z
+ProjectedBoxCorners projectBoxCorners(const glm::vec3& lightPos, const glm::vec3& boxMin, const glm::vec3& boxMax);
+
+// 闭式剪影：按光源相对盒子的 27 个区域查表，直接得到 CCW 的投影 hull（无排序、无分配）
+// 返回顶点数（退化时 <3）；光源不在盒子 z 上方时返回 -1，调用方应回退到通用凸包
+int boxSilhouetteOnWall(const glm::vec3& lightPos,
+                        const glm::vec3& boxMin, const glm::vec3& boxMax,
+                        glm::vec2 out[kMaxSilhouetteVerts]);
+
+// 同上，但角点已经投好（批量 SIMD 路径）；结果与 boxSilhouetteOnWall 逐位一致
+int silhouetteFromProjected(const glm::vec3& lightPos,
+                            const glm::vec3& boxMin, const glm::vec3& boxMax,
+                            const ProjectedBoxCorners& projected,
+                            glm::vec2 out[kMaxSilhouetteVerts]);
+
+} // namespace geom
+
+#endif // SHADOW_GEOM_HPP
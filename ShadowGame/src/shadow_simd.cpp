@@ -0,0 +1,325 @@
+// ============================================================================
+// File: src/shadow_simd.cpp
+// 三条路径公式完全相同：
+//   min = min(c - h, c + h), max = max(c - h, c + h)       （同 BoxObject::worldBounds）
+//   t   = -L.z / (z - L.z)                                   （同 projectBoxCorners）
+//   x'  = L.x + t * (x - L.x)
+// 只用 IEEE 的加减乘除和 min/max，所以各路径结果逐位相同，模拟的 state hash 不随 CPU 变。
+// （min/max 的参数顺序也和 glm::min/max 对齐：相等时取哪一个决定了 ±0 的符号）
+// AVX 版用 GCC/Clang 的 target 属性单独开指令集，整个工程不需要 -mavx。
+//
+// 圆-边穿透同理，每条边：
+//   t = clamp(((p - a) · e) * invLen2, 0, 1)，按 max(t, 0) 再 min(t, 1) 的顺序（与 maxps/minps 语义一致）
+//   d = p - (a + t e)，pen = r - sqrt(max(|d|^2, 1e-12))，仅当 |d|^2 < r^2 且 pen > 0 时算压入
+// ============================================================================
+#include "shadow_simd.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SHADOW_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SHADOW_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SHADOW_SIMD_TARGET_AVX __attribute__((target("avx")))
+#else
+#define SHADOW_SIMD_TARGET_AVX
+#endif
+
+namespace geom {
+namespace {
+
+// 标量：处理 [begin, count)，也给 SIMD 路径收尾
+void projectScalar(const glm::vec3& L, const BoxBatchSoA& in, ProjectedBatchSoA& out, int begin) {
+    for (int i = begin; i < in.count; ++i) {
+        const float c[3] = {in.cx[i], in.cy[i], in.cz[i]};
+        const float h[3] = {in.hx[i], in.hy[i], in.hz[i]};
+        float mn[3], mx[3];
+        for (int k = 0; k < 3; ++k) {
+            const float a = c[k] - h[k];
+            const float b = c[k] + h[k];
+            mn[k] = (b < a) ? b : a;
+            mx[k] = (a < b) ? b : a;
+        }
+        const float t[2] = {-L.z / (mn[2] - L.z), -L.z / (mx[2] - L.z)};
+        for (int z = 0; z < 2; ++z) {
+            out.x[z][0][i] = L.x + t[z] * (mn[0] - L.x);
+            out.x[z][1][i] = L.x + t[z] * (mx[0] - L.x);
+            out.y[z][0][i] = L.y + t[z] * (mn[1] - L.y);
+            out.y[z][1][i] = L.y + t[z] * (mx[1] - L.y);
+        }
+        out.lightAbove[i] = L.z > mx[2];
+    }
+}
+
+#ifdef SHADOW_SIMD_X86
+
+// SSE2 是 x86-64 的基线，不用额外开指令集
+int projectSse2(const glm::vec3& L, const BoxBatchSoA& in, ProjectedBatchSoA& out) {
+    const __m128 lx = _mm_set1_ps(L.x);
+    const __m128 ly = _mm_set1_ps(L.y);
+    const __m128 lz = _mm_set1_ps(L.z);
+    const __m128 nlz = _mm_set1_ps(-L.z);
+
+    int i = 0;
+    for (; i + 4 <= in.count; i += 4) {
+        const __m128 cx = _mm_load_ps(in.cx + i), hx = _mm_load_ps(in.hx + i);
+        const __m128 cy = _mm_load_ps(in.cy + i), hy = _mm_load_ps(in.hy + i);
+        const __m128 cz = _mm_load_ps(in.cz + i), hz = _mm_load_ps(in.hz + i);
+
+        const __m128 ax = _mm_sub_ps(cx, hx), bx = _mm_add_ps(cx, hx);
+        const __m128 ay = _mm_sub_ps(cy, hy), by = _mm_add_ps(cy, hy);
+        const __m128 az = _mm_sub_ps(cz, hz), bz = _mm_add_ps(cz, hz);
+        const __m128 dx0 = _mm_sub_ps(_mm_min_ps(bx, ax), lx), dx1 = _mm_sub_ps(_mm_max_ps(bx, ax), lx);
+        const __m128 dy0 = _mm_sub_ps(_mm_min_ps(by, ay), ly), dy1 = _mm_sub_ps(_mm_max_ps(by, ay), ly);
+        const __m128 zMin = _mm_min_ps(bz, az), zMax = _mm_max_ps(bz, az);
+
+        const __m128 t[2] = {_mm_div_ps(nlz, _mm_sub_ps(zMin, lz)), _mm_div_ps(nlz, _mm_sub_ps(zMax, lz))};
+        for (int z = 0; z < 2; ++z) {
+            _mm_store_ps(out.x[z][0] + i, _mm_add_ps(lx, _mm_mul_ps(t[z], dx0)));
+            _mm_store_ps(out.x[z][1] + i, _mm_add_ps(lx, _mm_mul_ps(t[z], dx1)));
+            _mm_store_ps(out.y[z][0] + i, _mm_add_ps(ly, _mm_mul_ps(t[z], dy0)));
+            _mm_store_ps(out.y[z][1] + i, _mm_add_ps(ly, _mm_mul_ps(t[z], dy1)));
+        }
+        const int above = _mm_movemask_ps(_mm_cmplt_ps(zMax, lz));
+        for (int k = 0; k < 4; ++k) out.lightAbove[i + k] = (above >> k) & 1;
+    }
+    return i;
+}
+
+SHADOW_SIMD_TARGET_AVX
+int projectAvx(const glm::vec3& L, const BoxBatchSoA& in, ProjectedBatchSoA& out) {
+    const __m256 lx = _mm256_set1_ps(L.x);
+    const __m256 ly = _mm256_set1_ps(L.y);
+    const __m256 lz = _mm256_set1_ps(L.z);
+    const __m256 nlz = _mm256_set1_ps(-L.z);
+
+    int i = 0;
+    for (; i + 8 <= in.count; i += 8) {
+        const __m256 cx = _mm256_load_ps(in.cx + i), hx = _mm256_load_ps(in.hx + i);
+        const __m256 cy = _mm256_load_ps(in.cy + i), hy = _mm256_load_ps(in.hy + i);
+        const __m256 cz = _mm256_load_ps(in.cz + i), hz = _mm256_load_ps(in.hz + i);
+
+        const __m256 ax = _mm256_sub_ps(cx, hx), bx = _mm256_add_ps(cx, hx);
+        const __m256 ay = _mm256_sub_ps(cy, hy), by = _mm256_add_ps(cy, hy);
+        const __m256 az = _mm256_sub_ps(cz, hz), bz = _mm256_add_ps(cz, hz);
+        const __m256 dx0 = _mm256_sub_ps(_mm256_min_ps(bx, ax), lx), dx1 = _mm256_sub_ps(_mm256_max_ps(bx, ax), lx);
+        const __m256 dy0 = _mm256_sub_ps(_mm256_min_ps(by, ay), ly), dy1 = _mm256_sub_ps(_mm256_max_ps(by, ay), ly);
+        const __m256 zMin = _mm256_min_ps(bz, az), zMax = _mm256_max_ps(bz, az);
+
+        const __m256 t0 = _mm256_div_ps(nlz, _mm256_sub_ps(zMin, lz));
+        const __m256 t1 = _mm256_div_ps(nlz, _mm256_sub_ps(zMax, lz));
+        _mm256_store_ps(out.x[0][0] + i, _mm256_add_ps(lx, _mm256_mul_ps(t0, dx0)));
+        _mm256_store_ps(out.x[0][1] + i, _mm256_add_ps(lx, _mm256_mul_ps(t0, dx1)));
+        _mm256_store_ps(out.y[0][0] + i, _mm256_add_ps(ly, _mm256_mul_ps(t0, dy0)));
+        _mm256_store_ps(out.y[0][1] + i, _mm256_add_ps(ly, _mm256_mul_ps(t0, dy1)));
+        _mm256_store_ps(out.x[1][0] + i, _mm256_add_ps(lx, _mm256_mul_ps(t1, dx0)));
+        _mm256_store_ps(out.x[1][1] + i, _mm256_add_ps(lx, _mm256_mul_ps(t1, dx1)));
+        _mm256_store_ps(out.y[1][0] + i, _mm256_add_ps(ly, _mm256_mul_ps(t1, dy0)));
+        _mm256_store_ps(out.y[1][1] + i, _mm256_add_ps(ly, _mm256_mul_ps(t1, dy1)));
+
+        const int above = _mm256_movemask_ps(_mm256_cmp_ps(zMax, lz, _CMP_LT_OQ));
+        for (int k = 0; k < 8; ++k) out.lightAbove[i + k] = (above >> k) & 1;
+    }
+    return i;
+}
+
+bool cpuHasAvx() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx");
+#elif defined(_MSC_VER)
+    // CPUID.1:ECX 的 OSXSAVE(27) + AVX(28)，再确认 OS 保存了 YMM 状态
+    int r[4];
+    __cpuid(r, 1);
+    if ((r[2] & (1 << 27)) == 0 || (r[2] & (1 << 28)) == 0) return false;
+    return (_xgetbv(0) & 0x6) == 0x6;
+#else
+    return false;
+#endif
+}
+
+#endif // SHADOW_SIMD_X86
+
+// ---- 圆 vs 打包边 ----
+// 各路径只负责把每条边的穿透深度写进 pen[i]（没压入 = 0），挑最深的一条在外面统一做
+
+void edgeDepthsScalar(const float* ed, unsigned mask, const glm::vec2& p, float r, float pen[HullPool::kStride]) {
+    const float r2 = r * r;
+    for (int i = 0; i < HullPool::kStride; ++i) {
+        pen[i] = 0.0f;
+        if (!(mask & (1u << i))) continue;
+        const float ax = ed[kEdgeAx * HullPool::kStride + i], ay = ed[kEdgeAy * HullPool::kStride + i];
+        const float ex = ed[kEdgeEx * HullPool::kStride + i], ey = ed[kEdgeEy * HullPool::kStride + i];
+        float t = ((p.x - ax) * ex + (p.y - ay) * ey) * ed[kEdgeInvLen2 * HullPool::kStride + i];
+        t = (t > 0.0f) ? t : 0.0f;
+        t = (t < 1.0f) ? t : 1.0f;
+        const float dx = p.x - (ax + t * ex);
+        const float dy = p.y - (ay + t * ey);
+        const float d2 = dx * dx + dy * dy;
+        const float dist = std::sqrt((d2 > 1e-12f) ? d2 : 1e-12f);
+        const float depth = r - dist;
+        if (d2 < r2 && depth > 0.0f) pen[i] = depth;
+    }
+}
+
+#ifdef SHADOW_SIMD_X86
+
+void edgeDepthsSse2(const float* ed, unsigned mask, const glm::vec2& p, float r, float pen[HullPool::kStride]) {
+    const __m128 px = _mm_set1_ps(p.x), py = _mm_set1_ps(p.y);
+    const __m128 rv = _mm_set1_ps(r), r2 = _mm_set1_ps(r * r);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), eps = _mm_set1_ps(1e-12f);
+    const __m128i bits = _mm_set_epi32(8, 4, 2, 1);
+
+    for (int i = 0; i < HullPool::kStride; i += 4) {
+        const __m128 ax = _mm_loadu_ps(ed + kEdgeAx * HullPool::kStride + i);
+        const __m128 ay = _mm_loadu_ps(ed + kEdgeAy * HullPool::kStride + i);
+        const __m128 ex = _mm_loadu_ps(ed + kEdgeEx * HullPool::kStride + i);
+        const __m128 ey = _mm_loadu_ps(ed + kEdgeEy * HullPool::kStride + i);
+        const __m128 inv = _mm_loadu_ps(ed + kEdgeInvLen2 * HullPool::kStride + i);
+
+        const __m128 dot = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(px, ax), ex), _mm_mul_ps(_mm_sub_ps(py, ay), ey));
+        const __m128 t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(dot, inv), zero), one);
+        const __m128 dx = _mm_sub_ps(px, _mm_add_ps(ax, _mm_mul_ps(t, ex)));
+        const __m128 dy = _mm_sub_ps(py, _mm_add_ps(ay, _mm_mul_ps(t, ey)));
+        const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const __m128 depth = _mm_sub_ps(rv, _mm_sqrt_ps(_mm_max_ps(d2, eps)));
+
+        const __m128i laneBits = _mm_and_si128(_mm_set1_epi32((int)(mask >> i)), bits);
+        const __m128 inMask = _mm_castsi128_ps(_mm_cmpeq_epi32(laneBits, bits));
+        const __m128 hit = _mm_and_ps(inMask, _mm_and_ps(_mm_cmplt_ps(d2, r2), _mm_cmpgt_ps(depth, zero)));
+        _mm_storeu_ps(pen + i, _mm_and_ps(hit, depth));
+    }
+}
+
+SHADOW_SIMD_TARGET_AVX
+void edgeDepthsAvx(const float* ed, unsigned mask, const glm::vec2& p, float r, float pen[HullPool::kStride]) {
+    static_assert(HullPool::kStride == 8, "one AVX register per hull");
+    const __m256 px = _mm256_set1_ps(p.x), py = _mm256_set1_ps(p.y);
+    const __m256 rv = _mm256_set1_ps(r), r2 = _mm256_set1_ps(r * r);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), eps = _mm256_set1_ps(1e-12f);
+
+    const __m256 ax = _mm256_loadu_ps(ed + kEdgeAx * HullPool::kStride);
+    const __m256 ay = _mm256_loadu_ps(ed + kEdgeAy * HullPool::kStride);
+    const __m256 ex = _mm256_loadu_ps(ed + kEdgeEx * HullPool::kStride);
+    const __m256 ey = _mm256_loadu_ps(ed + kEdgeEy * HullPool::kStride);
+    const __m256 inv = _mm256_loadu_ps(ed + kEdgeInvLen2 * HullPool::kStride);
+
+    const __m256 dot = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(px, ax), ex), _mm256_mul_ps(_mm256_sub_ps(py, ay), ey));
+    const __m256 t = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(dot, inv), zero), one);
+    const __m256 dx = _mm256_sub_ps(px, _mm256_add_ps(ax, _mm256_mul_ps(t, ex)));
+    const __m256 dy = _mm256_sub_ps(py, _mm256_add_ps(ay, _mm256_mul_ps(t, ey)));
+    const __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    const __m256 depth = _mm256_sub_ps(rv, _mm256_sqrt_ps(_mm256_max_ps(d2, eps)));
+
+    // AVX1 没有 256 位整数比较：mask 展开成 8 个 lane 的全 1 / 全 0
+    alignas(32) std::uint32_t laneMask[8];
+    for (int i = 0; i < 8; ++i) laneMask[i] = (mask >> i) & 1u ? 0xFFFFFFFFu : 0u;
+    const __m256 inMask = _mm256_load_ps(reinterpret_cast<const float*>(laneMask));
+    const __m256 hit = _mm256_and_ps(inMask, _mm256_and_ps(_mm256_cmp_ps(d2, r2, _CMP_LT_OQ),
+                                                           _mm256_cmp_ps(depth, zero, _CMP_GT_OQ)));
+    _mm256_storeu_ps(pen, _mm256_and_ps(hit, depth));
+}
+
+#endif // SHADOW_SIMD_X86
+
+SimdPath detectOnce() {
+#ifdef SHADOW_SIMD_X86
+    return cpuHasAvx() ? SimdPath::Avx : SimdPath::Sse2;
+#else
+    return SimdPath::Scalar;
+#endif
+}
+
+std::atomic<int> g_active{-1};   // -1 = 还没选过
+
+} // namespace
+
+SimdPath detectSimdPath() {
+    static const SimdPath best = detectOnce();
+    return best;
+}
+
+SimdPath activeSimdPath() {
+    const int p = g_active.load(std::memory_order_relaxed);
+    return p < 0 ? detectSimdPath() : (SimdPath)p;
+}
+
+void setSimdPath(SimdPath path) {
+    if ((int)path > (int)detectSimdPath()) path = detectSimdPath();
+    g_active.store((int)path, std::memory_order_relaxed);
+}
+
+const char* simdPathName(SimdPath path) {
+    switch (path) {
+    case SimdPath::Scalar: return "scalar";
+    case SimdPath::Sse2:   return "sse2";
+    case SimdPath::Avx:    return "avx";
+    }
+    return "?";
+}
+
+bool parseSimdPath(const char* s, SimdPath& out) {
+    if (!std::strcmp(s, "scalar")) out = SimdPath::Scalar;
+    else if (!std::strcmp(s, "sse2") || !std::strcmp(s, "sse")) out = SimdPath::Sse2;
+    else if (!std::strcmp(s, "avx")) out = SimdPath::Avx;
+    else return false;
+    return true;
+}
+
+void projectBoxBatch(const glm::vec3& lightPos, const BoxBatchSoA& in, ProjectedBatchSoA& out) {
+    int done = 0;
+#ifdef SHADOW_SIMD_X86
+    switch (activeSimdPath()) {
+    case SimdPath::Avx:    done = projectAvx(lightPos, in, out); break;
+    case SimdPath::Sse2:   done = projectSse2(lightPos, in, out); break;
+    case SimdPath::Scalar: break;
+    }
+#endif
+    projectScalar(lightPos, in, out, done);
+}
+
+EdgePenetration deepestEdgePenetration(const HullView& poly, unsigned mask, const glm::vec2& center, float r) {
+    EdgePenetration out;
+    if (!poly.valid() || mask == 0u) return out;
+
+    alignas(32) float pen[HullPool::kStride];
+    switch (activeSimdPath()) {
+#ifdef SHADOW_SIMD_X86
+    case SimdPath::Avx:  edgeDepthsAvx(poly.edges, mask, center, r, pen); break;
+    case SimdPath::Sse2: edgeDepthsSse2(poly.edges, mask, center, r, pen); break;
+#endif
+    default:             edgeDepthsScalar(poly.edges, mask, center, r, pen); break;
+    }
+
+    for (int i = 0; i < HullPool::kStride; ++i) {
+        if (pen[i] > out.depth) {
+            out.depth = pen[i];
+            out.edge = i;
+        }
+    }
+    if (out.edge < 0) return out;
+
+    // 只给最深的那条算法线：重算 d（与 kernel 同一组运算，结果逐位相同）
+    const float* ed = poly.edges;
+    const int i = out.edge;
+    const float ax = ed[kEdgeAx * HullPool::kStride + i], ay = ed[kEdgeAy * HullPool::kStride + i];
+    const float ex = ed[kEdgeEx * HullPool::kStride + i], ey = ed[kEdgeEy * HullPool::kStride + i];
+    float t = ((center.x - ax) * ex + (center.y - ay) * ey) * ed[kEdgeInvLen2 * HullPool::kStride + i];
+    t = (t > 0.0f) ? t : 0.0f;
+    t = (t < 1.0f) ? t : 1.0f;
+    const glm::vec2 d(center.x - (ax + t * ex), center.y - (ay + t * ey));
+    const float d2 = d.x * d.x + d.y * d.y;
+    const float dist = std::sqrt((d2 > 1e-12f) ? d2 : 1e-12f);
+    out.normal = (dist > 1e-6f) ? d * (1.0f / dist) : poly.normals[i];
+    return out;
+}
+
+} // namespace geom
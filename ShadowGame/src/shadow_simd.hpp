@@ -0,0 +1,81 @@
+// ============================================================================
+// File: src/shadow_simd.hpp
+// 批量角点投影：一批盒子（中心 + 半边长，SoA）在 SIMD 里生成 8 个角点并投到墙面 z=0。
+// 盒子轴对齐，同一 z 面上 4 个角点共用一个缩放系数，所以 8 个投影角点正好是
+// z=min / z=max 两个面各自投出的轴对齐矩形：输出按 [z 面][min/max] 存 x、y 两组。
+//
+// 运行时按 CPU 选路径（AVX 一次 8 个盒子，SSE2 一次 4 个，其余标量），
+// 每条路径与 boxSilhouetteOnWall 的标量公式逐位一致（同样的运算顺序，不用 FMA）。
+//
+// 另有圆 vs hull 打包边的穿透 kernel（侧墙 / 天花板），一个 hull 最多 8 条边正好一个 AVX 寄存器。
+// ============================================================================
+#pragma once
+#ifndef SHADOW_SIMD_HPP
+#define SHADOW_SIMD_HPP
+
+#include <glm/glm.hpp>
+
+#include "hull_pool.hpp"
+#include "shadow_geom.hpp"
+
+namespace geom {
+
+enum class SimdPath { Scalar, Sse2, Avx };
+
+// 这台机器能用的最好一档
+SimdPath detectSimdPath();
+// 当前生效的路径（默认 detectSimdPath()）；bench / headless 用 setSimdPath 强制降档对比，
+// 超过 CPU 能力的请求会被压到 detectSimdPath()
+SimdPath activeSimdPath();
+void setSimdPath(SimdPath path);
+const char* simdPathName(SimdPath path);
+bool parseSimdPath(const char* s, SimdPath& out);
+
+// 一批的容量（8 的倍数：AVX 不需要处理批内尾巴，除非 count 不整）
+constexpr int kProjectBatch = 64;
+
+struct BoxBatchSoA {
+    alignas(32) float cx[kProjectBatch];
+    alignas(32) float cy[kProjectBatch];
+    alignas(32) float cz[kProjectBatch];
+    alignas(32) float hx[kProjectBatch];   // 0.5 * scale（可以为负，和 worldBounds 一样取 min/max）
+    alignas(32) float hy[kProjectBatch];
+    alignas(32) float hz[kProjectBatch];
+    int count = 0;
+};
+
+struct ProjectedBatchSoA {
+    // [z 面：0 = zMin, 1 = zMax][0 = min 侧, 1 = max 侧][盒子]
+    alignas(32) float x[2][2][kProjectBatch];
+    alignas(32) float y[2][2][kProjectBatch];
+    // 光源 z 是否严格大于盒子 zMax（否则投影无意义，调用方回退到通用凸包）
+    bool lightAbove[kProjectBatch];
+};
+
+// 投影 in 的前 in.count 个盒子
+void projectBoxBatch(const glm::vec3& lightPos, const BoxBatchSoA& in, ProjectedBatchSoA& out);
+
+// 取出第 i 个盒子的投影角点，交给 silhouetteFromProjected
+inline ProjectedBoxCorners projectedCorners(const ProjectedBatchSoA& p, int i) {
+    ProjectedBoxCorners c;
+    for (int z = 0; z < 2; ++z)
+        for (int s = 0; s < 2; ++s) {
+            c.x[z][s] = p.x[z][s][i];
+            c.y[z][s] = p.y[z][s][i];
+        }
+    return c;
+}
+
+struct EdgePenetration {
+    int edge = -1;                 // -1：mask 里没有任何边被压入
+    float depth = 0.0f;            // r - 圆心到线段距离
+    glm::vec2 normal{0.0f};        // 从边指向圆心；圆心正好在边上时取边的外法线
+};
+
+// 圆 (center, r) 对 poly 的打包边，只看 mask 置位的边（通常是 wallMaskRising / wallMaskFalling）。
+// 一趟返回压得最深的那条；深度相同取下标小的（与逐边 “pen > best” 扫描的结果一致）
+EdgePenetration deepestEdgePenetration(const HullView& poly, unsigned mask, const glm::vec2& center, float r);
+
+} // namespace geom
+
+#endif // SHADOW_SIMD_HPP
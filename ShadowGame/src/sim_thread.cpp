@@ -0,0 +1,110 @@
+// File: src/sim_thread.cpp
+#include "sim_thread.hpp"
+
+#include <algorithm>
+
+#include "profiler.hpp"
+
+namespace {
+constexpr int kStride = HullPool::kStride;
+}
+
+void SimFrame::copyHulls(const ShadowWorld& world) {
+    const HullPool& pool = world.platforms();
+    const int n = pool.size();
+
+    // 三缓冲里每一份都记着自己上次拷到的版本；槽位数变了（换关卡）或第一次拷就整份拷
+    // vector 赋值 / resize：容量够就不重新分配
+    if (hullsVersion == ~0ull || hulls.size() != n) {
+        const HullVertsView v = pool.vertsView();
+        hulls.verts.assign(v.verts, v.verts + (size_t)n * kStride);
+        hulls.counts.assign(v.counts, v.counts + n);
+        return;
+    }
+    for (int slot = 0; slot < n; ++slot) {
+        if (world.hullVersionOf(slot) <= hullsVersion) continue;
+        std::copy_n(pool.verts(slot), kStride, hulls.verts.data() + (size_t)slot * kStride);
+        hulls.counts[(size_t)slot] = pool.count(slot);
+    }
+}
+
+void SimFrame::capture(const ShadowWorld& world, bool withHulls) {
+    prev = world.prevSnapshot();
+    cur = world.captureSnapshot();
+    light = world.light();
+    camera = world.camera();
+    ballRadius = world.ball().radius;
+    shadowStats = world.shadowStats();
+
+    if (withHulls && hullsVersion != world.hullsVersion()) {
+        copyHulls(world);
+        hullsVersion = world.hullsVersion();
+    }
+    if (objectsVersion != world.objectsVersion()) {
+        objects = world.objects();
+        objectsVersion = world.objectsVersion();
+    }
+}
+
+SimThread::SimThread(ShadowWorld& world, double tickHz, int maxStepsPerFrame)
+    : world_(world),
+      tickDt_(1.0 / std::max(tickHz, 1.0)),
+      maxSteps_(std::max(maxStepsPerFrame, 1)) {}
+
+SimThread::~SimThread() {
+    stop();
+}
+
+void SimThread::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop() {
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+}
+
+const SimFrame* SimThread::latest() {
+    if (frames_.acquire()) haveFrame_ = true;
+    return haveFrame_ ? &frames_.readSlot() : nullptr;
+}
+
+float SimThread::alpha(const SimFrame& frame) const {
+    const double since = std::chrono::duration<double>(std::chrono::steady_clock::now() - frame.publishedAt).count();
+    return (float)std::clamp(since / tickDt_, 0.0, 1.0);
+}
+
+void SimThread::run() {
+    using Clock = std::chrono::steady_clock;
+    const Clock::duration tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(tickDt_));
+    const float dt = (float)tickDt_;
+
+    Clock::time_point next = Clock::now();
+    while (running_.load(std::memory_order_acquire)) {
+        const Clock::time_point now = Clock::now();
+        if (now < next) {
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        // 和 FixedStepClock 一样：落后太多时最多补 maxSteps 个 tick，剩下的时间丢掉
+        int steps = 0;
+        while (next <= now && steps < maxSteps_) {
+            InputState in;
+            in.bits = input_.load(std::memory_order_relaxed);
+            world_.step(in, dt);
+            next += tick;
+            ++steps;
+        }
+        if (next <= now) next = now + tick;
+        ticks_.fetch_add((std::uint64_t)steps, std::memory_order_relaxed);
+
+        SG_PROFILE_SCOPE("sim/publish");
+        SimFrame& f = frames_.writeSlot();
+        f.capture(world_, captureHulls_.load(std::memory_order_relaxed));
+        f.tick = ticks_.load(std::memory_order_relaxed);
+        f.publishedAt = Clock::now();
+        frames_.publish();
+    }
+}
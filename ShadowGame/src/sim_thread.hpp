@@ -0,0 +1,98 @@
+// ============================================================================
+// File: src/sim_thread.hpp
+// 模拟线程：按固定 tick 推进 ShadowWorld，每个 tick 把渲染需要的状态拷进 SimFrame，
+// 经三缓冲发布。渲染线程只读最新一份，互不等待。
+// 输入由主线程（GLFW 只能在主线程 poll）写进一个原子量，模拟线程每个 tick 读一次。
+// ============================================================================
+#pragma once
+#ifndef SIM_THREAD_HPP
+#define SIM_THREAD_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "triple_buffer.hpp"
+#include "world.hpp"
+
+// CPU 阴影 mesh 要的 hull 数据：只有顶点和顶点数（法线 / 打包边 / AABB 是物理用的，不拷）
+struct SimHullVerts {
+    std::vector<glm::vec2> verts;   // size() * HullPool::kStride
+    std::vector<int> counts;
+
+    int size() const { return (int)counts.size(); }
+    HullVertsView view() const { return HullVertsView{verts.data(), counts.data(), size()}; }
+};
+
+// 一个 tick 结束时渲染需要的全部状态（不可变：发布后只给渲染线程读）
+struct SimFrame {
+    RenderSnapshot prev;        // 上一 tick
+    RenderSnapshot cur;         // 本 tick
+    LightSource light;
+    Camera camera;
+    float ballRadius = 0.5f;
+
+    // hull / 盒子只在版本变化时才拷（槽位复用，通常什么都不用拷）
+    // hull 只拷 hullsVersion 之后重算过的槽位；光源在动时所有槽位都会变，但也只是顶点
+    // （hull 只有 CPU 阴影 mesh 才需要；GPU 投影模式下不拷，hullsVersion 保持旧值）
+    SimHullVerts hulls;
+    std::uint64_t hullsVersion = ~0ull;
+    std::vector<BoxObject> objects;
+    std::uint64_t objectsVersion = ~0ull;
+
+    ShadowRebuildStats shadowStats;
+    std::uint64_t tick = 0;
+    std::chrono::steady_clock::time_point publishedAt{};
+
+    void capture(const ShadowWorld& world, bool withHulls);
+
+private:
+    void copyHulls(const ShadowWorld& world);
+};
+
+class SimThread final {
+public:
+    // world 在线程运行期间归模拟线程独占；start 之前 / stop 之后才能从外面碰
+    SimThread(ShadowWorld& world, double tickHz, int maxStepsPerFrame);
+    ~SimThread();
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    void start();
+    void stop();
+
+    // 主线程：最新输入（下一个 tick 生效）
+    void setInput(const InputState& in) { input_.store(in.bits, std::memory_order_relaxed); }
+    // 渲染端用 CPU hull mesh 时才需要每帧带上 hull
+    void setCaptureHulls(bool on) { captureHulls_.store(on, std::memory_order_relaxed); }
+
+    // 渲染线程：拿最新发布的一帧（没有新的就还是上一次那份）；还没发布过返回 nullptr
+    const SimFrame* latest();
+
+    // 上一个 tick 到下一个 tick 之间的位置 [0,1)：按 frame 发布时刻算
+    float alpha(const SimFrame& frame) const;
+
+    double tickDt() const { return tickDt_; }
+    std::uint64_t ticks() const { return ticks_.load(std::memory_order_relaxed); }
+
+private:
+    ShadowWorld& world_;
+    double tickDt_;
+    int maxSteps_;
+
+    TripleBuffer<SimFrame> frames_;
+    bool haveFrame_ = false;   // 读端
+
+    std::atomic<std::uint16_t> input_{0};
+    std::atomic<bool> captureHulls_{true};
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> ticks_{0};
+    std::thread thread_;
+
+    void run();
+};
+
+#endif // SIM_THREAD_HPP
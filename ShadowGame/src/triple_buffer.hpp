@@ -0,0 +1,53 @@
+// ============================================================================
+// File: src/triple_buffer.hpp
+// 单生产者 / 单消费者三缓冲：写端永远有一块自己的槽位可写，读端永远有一块自己的槽位可读，
+// 中间那块通过一个原子字节交换。双方都不会阻塞，读端拿到的总是最新发布的那一份
+// （中间被覆盖的旧帧直接丢掉）。
+// 槽位对象会被反复复用：写端拿到的槽位可能是 2 次发布之前的内容，增量更新要自己判断版本。
+// ============================================================================
+#pragma once
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class TripleBuffer final {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ---- 写端（只能一个线程） ----
+    T& writeSlot() { return slots_[writeIdx_]; }
+    // 发布 writeSlot()，换一块槽位继续写
+    void publish() {
+        const std::uint8_t prev = middle_.exchange((std::uint8_t)(writeIdx_ | kFresh), std::memory_order_acq_rel);
+        writeIdx_ = prev & kIndexMask;
+    }
+
+    // ---- 读端（只能一个线程） ----
+    // 有新发布就换过来；返回是否换了
+    bool acquire() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        const std::uint8_t prev = middle_.exchange(readIdx_, std::memory_order_acq_rel);
+        readIdx_ = prev & kIndexMask;
+        return true;
+    }
+    // 读端当前持有的槽位（acquire 之前可能是默认构造的空对象）
+    const T& readSlot() const { return slots_[readIdx_]; }
+
+private:
+    static constexpr std::uint8_t kIndexMask = 0x3;
+    static constexpr std::uint8_t kFresh = 0x4;   // 中间槽位是写端新发布的、读端还没拿走
+
+    std::array<T, 3> slots_{};
+    std::uint8_t writeIdx_ = 0;
+    std::uint8_t readIdx_ = 1;
+    std::atomic<std::uint8_t> middle_{2};
+};
+
+#endif // TRIPLE_BUFFER_HPP
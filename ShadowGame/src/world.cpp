@@ -0,0 +1,618 @@
+// ============================================================================
+// File: src/world.cpp  (模拟部分：重建平台、粘连、掉出光圈、出生点)
+// ============================================================================
+#include "world.hpp"
+#include "job_system.hpp"
+#include "profiler.hpp"
+#include "shadow_geom.hpp"
+#include "shadow_simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+static glm::vec3 cardboard(float t) {
+    // t 用来做一点点颜色变化，范围随意
+    return glm::vec3(0.72f + 0.05f * t, 0.60f + 0.04f * t, 0.42f + 0.02f * t);
+}
+
+static bool pickSpawnOnPlatformTopInLight(const HullView& sp,
+                                         const glm::vec2& lightCenter,
+                                         float lightRadius,
+                                         float ballRadius,
+                                         glm::vec2& outSpawn,
+                                         float& outU) {
+    if (!sp.valid()) return false;
+
+    const float minX = sp.minX;
+    const float maxX = sp.maxX;
+
+    const float w = std::max(maxX - minX, 1e-5f);
+
+    // 采样一些 x，找一个“顶面存在 + 落点在光圈内”的点
+    // 选策略：优先靠近中间，同时尽量 yTop 更高（更像站在平台上沿）
+    const int samples = 11;
+    bool found = false;
+    float bestScore = -std::numeric_limits<float>::infinity();
+
+    for (int i = 0; i < samples; ++i) {
+        const float u = (float)i / (float)(samples - 1);
+        const float x = minX + u * w;
+
+        float yTop = -std::numeric_limits<float>::infinity();
+        // 直接复用你 ShadowWorld::topYAtX 的逻辑（这里为了不引入依赖，用同样思路再算一次）
+        // 你如果愿意，也可以把 ShadowWorld::topYAtX 改成 static 并在此调用。
+        bool any = false;
+        float bestY = -std::numeric_limits<float>::infinity();
+        for (int e = 0; e < sp.count; ++e) {
+            const glm::vec2 a = sp.verts[e];
+            const glm::vec2 b = sp.verts[(e + 1) % sp.count];
+
+            const float minx = std::min(a.x, b.x);
+            const float maxx = std::max(a.x, b.x);
+            if (x < minx - 1e-5f || x > maxx + 1e-5f) continue;
+
+            const float dx = b.x - a.x;
+            if (std::fabs(dx) < 1e-6f) {
+                if (std::fabs(a.x - x) < 1e-4f) {
+                    bestY = std::max(bestY, std::max(a.y, b.y));
+                    any = true;
+                }
+                continue;
+            }
+
+            const float t = (x - a.x) / dx;
+            if (t < -1e-4f || t > 1.0f + 1e-4f) continue;
+
+            const float y = a.y + t * (b.y - a.y);
+            bestY = std::max(bestY, y);
+            any = true;
+        }
+
+        if (!any) continue;
+        yTop = bestY;
+
+        const glm::vec2 landing(x, yTop + ballRadius);
+
+        // 必须在光圈内才算“可站立”
+        if (glm::distance(landing, lightCenter) > lightRadius) continue;
+
+        // score：更靠近中间更好，yTop 更高更好
+        const float centerBias = 1.0f - std::fabs(u - 0.5f) * 2.0f; // [0,1]
+        const float score = yTop * 10.0f + centerBias;
+
+        if (!found || score > bestScore) {
+            found = true;
+            bestScore = score;
+            outSpawn = landing;
+            outU = u;
+        }
+    }
+
+    // 如果完全找不到，就失败
+    return found;
+}
+
+static bool computeSpawnOnLeftmostPlatformInLight(const HullPool& platforms,
+                                                  const glm::vec2& lightCenter,
+                                                  float lightRadius,
+                                                  float ballRadius,
+                                                  glm::vec2& outSpawn,
+                                                  int& outObjectId,
+                                                  float& outU) {
+    bool foundAny = false;
+    float bestMinX = std::numeric_limits<float>::infinity();
+
+    for (int slot = 0; slot < platforms.size(); ++slot) {
+        if (!platforms.valid(slot)) continue;
+
+        const HullView sp = platforms.view(slot);
+        const float minX = sp.minX;
+
+        glm::vec2 spawn;
+        float u = 0.5f;
+        if (!pickSpawnOnPlatformTopInLight(sp, lightCenter, lightRadius, ballRadius, spawn, u)) continue;
+
+        // 选最左的平台
+        if (!foundAny || minX < bestMinX) {
+            foundAny = true;
+            bestMinX = minX;
+            outSpawn = spawn;
+            outObjectId = sp.objectId;
+            outU = u;
+        }
+    }
+
+    return foundAny;
+}
+
+static float cross2(const glm::vec2& o, const glm::vec2& a, const glm::vec2& b) {
+    const glm::vec2 oa = a - o;
+    const glm::vec2 ob = b - o;
+    return oa.x * ob.y - oa.y * ob.x;
+}
+
+// 通用路径：8 个角点全部投影后求凸包。作为剪影查表的参考实现保留
+ShadowWorld::HullPoints ShadowWorld::referenceHull(const glm::vec3& lightPos,
+                                                   const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                                   std::pmr::memory_resource* mr) {
+    HullPoints pts(mr);
+    pts.reserve(8);
+    for (int c = 0; c < 8; ++c) pts.push_back(geom::projectToWallZ0(lightPos, geom::boxCorner(boxMin, boxMax, c)));
+    return convexHull(std::move(pts));
+}
+
+// 查表剪影与参考凸包应当是同一个多边形（同顶点集、同为 CCW）
+bool ShadowWorld::silhouetteMatchesReference(const glm::vec3& lightPos,
+                                       const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                       const glm::vec2* hull, int n) {
+    const auto ref = referenceHull(lightPos, boxMin, boxMax);
+    if (ref.size() < 3) return n < 3;
+    if ((int)ref.size() != n) return false;
+
+    float area = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        const glm::vec2 a = hull[i];
+        const glm::vec2 b = hull[(i + 1) % n];
+        area += a.x * b.y - a.y * b.x;
+    }
+    if (area <= 0.0f) return false;
+
+    for (int i = 0; i < n; ++i) {
+        const glm::vec2 v = hull[i];
+        const float tol = 1e-4f * std::max(1.0f, std::fabs(v.x) + std::fabs(v.y));
+        bool found = false;
+        for (const auto& r : ref) found = found || (std::fabs(r.x - v.x) < tol && std::fabs(r.y - v.y) < tol);
+        if (!found) return false;
+    }
+    return true;
+}
+
+ShadowWorld::HullPoints ShadowWorld::convexHull(HullPoints pts) {
+    if (pts.size() <= 3) return pts;
+
+    std::sort(pts.begin(), pts.end(), [](auto& a, auto& b){
+        if (a.x != b.x) return a.x < b.x;
+        return a.y < b.y;
+    });
+    pts.erase(std::unique(pts.begin(), pts.end(), [](auto& a, auto& b){
+        return std::fabs(a.x-b.x)<1e-5f && std::fabs(a.y-b.y)<1e-5f;
+    }), pts.end());
+
+    // 一次开够：arena 上反复扩容只会白白浪费空间
+    HullPoints lower(pts.get_allocator()), upper(pts.get_allocator());
+    lower.reserve(pts.size() * 2);
+    upper.reserve(pts.size());
+    for (auto& p : pts) {
+        while (lower.size() >= 2 && cross2(lower[lower.size()-2], lower.back(), p) <= 0.0f) lower.pop_back();
+        lower.push_back(p);
+    }
+    for (int i=(int)pts.size()-1; i>=0; --i) {
+        auto p = pts[(size_t)i];
+        while (upper.size() >= 2 && cross2(upper[upper.size()-2], upper.back(), p) <= 0.0f) upper.pop_back();
+        upper.push_back(p);
+    }
+    lower.pop_back();
+    upper.pop_back();
+    lower.insert(lower.end(), upper.begin(), upper.end());
+    return lower;
+}
+
+bool ShadowWorld::topYAtX(const glm::vec2* poly, int n, float x, float& outYTop) {
+    float best = -std::numeric_limits<float>::infinity();
+    bool any = false;
+
+    for (int i=0;i<n;++i) {
+        const glm::vec2 a = poly[i];
+        const glm::vec2 b = poly[(i+1)%n];
+
+        const float minx = std::min(a.x, b.x);
+        const float maxx = std::max(a.x, b.x);
+        if (x < minx - 1e-5f || x > maxx + 1e-5f) continue;
+
+        const float dx = b.x - a.x;
+        if (std::fabs(dx) < 1e-6f) {
+            if (std::fabs(a.x - x) < 1e-4f) {
+                best = std::max(best, std::max(a.y, b.y));
+                any = true;
+            }
+            continue;
+        }
+
+        const float t = (x - a.x) / dx;
+        if (t < -1e-4f || t > 1.0f + 1e-4f) continue;
+
+        const float y = a.y + t * (b.y - a.y);
+        best = std::max(best, y);
+        any = true;
+    }
+
+    outYTop = best;
+    return any;
+}
+
+// O(1)：HullPool 自带 objectId -> slot 表
+bool ShadowWorld::findPlatformByObjectId(int objectId, HullView& out) const {
+    const int slot = shadowPlatforms_.slotOf(objectId);
+    if (slot < 0 || !shadowPlatforms_.valid(slot)) return false;
+    out = shadowPlatforms_.view(slot);
+    return true;
+}
+
+ShadowWorld::ShadowWorld()
+    : op_(&light_) {
+    initSceneObjects();
+}
+
+void ShadowWorld::resetLevel() {
+    // 1) reset light first
+    light_.position = spawnLight_;
+    light_.touch();
+
+    // 2) rebuild platforms for this light (so spawn uses correct shadow)
+    rebuildShadowPlatforms();
+
+    // 3) compute a VALID spawn: top boundary of leftmost platform AND inside light
+    const glm::vec2 lc = light_.footprintCenter();
+    const float lr = light_.footprintRadius();
+
+    glm::vec2 spawn = spawnBall_;
+    int supportObj = -1;
+    float supportU = 0.5f;
+
+    if (!computeSpawnOnLeftmostPlatformInLight(shadowPlatforms_, lc, lr, ball_.radius,
+                                               spawn, supportObj, supportU)) {
+        // fallback: 只要能看到球就行
+        spawn = glm::vec2(lc.x, lc.y);
+        supportObj = -1;
+        supportU = 0.5f;
+    }
+
+    // 4) place ball directly on platform and mark grounded
+    ball_.reset(spawn);
+    ball_.vel = glm::vec2(0.0f);
+
+    if (supportObj >= 0) {
+        ball_.forceGrounded(true);
+        ball_.setSupportObjectId(supportObj);
+        ball_.setSupportU(supportU);
+    } else {
+        ball_.drop();
+    }
+
+    // 瞬移：不要从旧位置插值过来
+    prevSnapshot_ = captureSnapshot();
+}
+
+
+void ShadowWorld::initSceneObjects() {
+    std::vector<BoxObject> objects;
+
+    auto addTower = [&](glm::vec3 centerXZ, float w, float d, float h, glm::vec3 col) {
+        BoxObject b;
+        b.scale = glm::vec3(w, h, d);
+        b.position = glm::vec3(centerXZ.x, h*0.5f, centerXZ.z);
+        b.color = col;
+        objects.push_back(b);
+    };
+
+    addTower(glm::vec3(-8.0f, 0.0f, 6.0f), 3.2f, 3.2f, 9.0f,  cardboard(-0.10f));
+    addTower(glm::vec3(-2.0f, 0.0f, 6.5f), 3.8f, 3.4f, 12.0f, cardboard( 0.05f));
+    addTower(glm::vec3( 6.0f, 0.0f, 6.0f), 3.0f, 4.6f, 10.0f, cardboard( 0.10f));
+
+    // plank on top
+    BoxObject plank;
+    plank.scale = glm::vec3(18.0f, 0.45f, 1.2f);
+    plank.position = glm::vec3(1.5f, 12.2f, 6.0f);
+    plank.color = glm::vec3(0.46f, 0.30f, 0.18f);
+    objects.push_back(plank);
+
+    loadLevel(std::move(objects), glm::vec3(-6.0f, 10.0f, 12.0f));
+}
+
+void ShadowWorld::loadLevel(std::vector<BoxObject> objects, const glm::vec3& lightSpawn) {
+    objects_ = std::move(objects);
+    ++objectsVersion_;
+
+    spawnLight_ = lightSpawn;
+    light_.position = spawnLight_;
+    light_.touch();
+
+    // objects_ 整体换了，旧缓存不能再用
+    invalidateShadowCache();
+
+    // 初始先算阴影，出生点最好在最左阴影平台上（找不到就放在光圈中心）
+    spawnBall_ = glm::vec2(-10.0f, 7.0f);
+    resetLevel();
+}
+
+void ShadowWorld::setLightPosition(const glm::vec3& p) {
+    light_.position = p;
+    light_.touch();
+}
+
+void ShadowWorld::invalidateShadowCache() {
+    shadowPlatforms_.reset(0);
+    shadowCache_.clear();
+    ++hullsVersion_;
+}
+
+// 重建完整平台 hull（不裁剪！）
+// 只重算 light 或 box version 变过的 hull，其余沿用上一帧结果
+namespace {
+// 每块的盒子数：一块约几十微秒，够摊掉一次抢块的原子操作，又能让 10k 级场景分到所有核
+constexpr int kShadowRebuildGrain = 256;
+}
+
+void ShadowWorld::setJobSystem(JobSystem* jobs) {
+    jobs_ = jobs;
+}
+
+void ShadowWorld::ensureScratch(int workers) {
+    while ((int)scratch_.size() < workers) scratch_.push_back(std::make_unique<FrameArena>());
+}
+
+void ShadowWorld::rebuildShadowRange(int begin, int end, ShadowRebuildStats& st, FrameArena& scratch) {
+    // 过期的盒子先攒成一批（中心 + 半边长 SoA），SIMD 一起投影 8 个角点，再逐个查表出剪影
+    geom::BoxBatchSoA batch;
+    geom::ProjectedBatchSoA projected;
+    int index[geom::kProjectBatch];
+
+    auto flush = [&] {
+        if (batch.count == 0) return;
+        geom::projectBoxBatch(light_.position, batch, projected);
+
+        for (int k = 0; k < batch.count; ++k) {
+            const int i = index[k];
+            glm::vec3 bmin, bmax;
+            objects_[(size_t)i].worldBounds(bmin, bmax);
+
+            // 快速路径：查表剪影，直接写进 i 号槽位（派生数据在 setHull 里一并算好）
+            glm::vec2 sil[geom::kMaxSilhouetteVerts];
+            const int n = projected.lightAbove[k]
+                ? geom::silhouetteFromProjected(light_.position, bmin, bmax, geom::projectedCorners(projected, k), sil)
+                : -1;
+            if (n >= 0) {
+                shadowPlatforms_.setHull(i, i, sil, n);   // n<3：退化，槽位保留但 count=0
+#ifdef SHADOWGAME_VALIDATE_SILHOUETTE
+                // 计数而不是 assert：Release 下也要能看到（headless 会打印并以非 0 退出）
+                if (!silhouetteMatchesReference(light_.position, bmin, bmax,
+                                                shadowPlatforms_.verts(i), shadowPlatforms_.count(i)))
+                    ++st.silhouetteMismatches;
+#endif
+            } else {
+                // 光源不在盒子上方：回退到 8 点投影 + 通用凸包（点集在 scratch 上，写完就收回）
+                const FrameArena::Scope scope(scratch);
+                const HullPoints hull = referenceHull(light_.position, bmin, bmax, scratch.resource());
+                shadowPlatforms_.setHull(i, i, hull.data(), (int)hull.size());
+            }
+        }
+        batch.count = 0;
+    };
+
+    for (int i=begin; i<end; ++i) {
+        const BoxObject& obj = objects_[(size_t)i];
+        ShadowCacheEntry& cache = shadowCache_[(size_t)i];
+        if (cache.valid &&
+            cache.lightVersion == light_.version &&
+            cache.objectVersion == obj.transformVersion) {
+            ++st.reused;
+            continue;
+        }
+
+        const int k = batch.count++;
+        index[k] = i;
+        batch.cx[k] = obj.position.x;
+        batch.cy[k] = obj.position.y;
+        batch.cz[k] = obj.position.z;
+        batch.hx[k] = 0.5f * obj.scale.x;   // 与 worldBounds 同一个表达式，投影结果逐位一致
+        batch.hy[k] = 0.5f * obj.scale.y;
+        batch.hz[k] = 0.5f * obj.scale.z;
+        if (batch.count == geom::kProjectBatch) flush();
+
+        cache.lightVersion = light_.version;
+        cache.objectVersion = obj.transformVersion;
+        cache.hullsVersion = hullsVersion_ + 1;   // 有重算，本次重建末尾一定会 ++hullsVersion_
+        cache.valid = true;
+
+        ++st.rebuilt;
+    }
+    flush();
+}
+
+void ShadowWorld::rebuildShadowPlatforms() {
+    shadowStats_.rebuilt = 0;
+    shadowStats_.reused = 0;
+    shadowStats_.silhouetteMismatches = 0;
+
+    bool resized = false;
+    if (shadowPlatforms_.size() != (int)objects_.size()) {
+        shadowPlatforms_.reset((int)objects_.size());   // slotOf_ 一次开够：并行 setHull 不会 resize
+        shadowCache_.assign(objects_.size(), ShadowCacheEntry{});
+        resized = true;
+    }
+
+    const int count = (int)objects_.size();
+    ensureScratch(jobs_ ? jobs_->concurrency() : 1);
+    if (!jobs_ || count <= kShadowRebuildGrain) {
+        rebuildShadowRange(0, count, shadowStats_, *scratch_[0]);
+    } else {
+        // 槽位 i 只由处理 i 的 worker 写（hull、派生数据、slotOf_[i]、cache[i] 都互不相交），
+        // 所以 hull 内容与分块/调度无关；只有计数走 per-worker 缓冲，按 worker 顺序加回来
+        workerShadowStats_.assign((size_t)jobs_->concurrency(), ShadowRebuildStats{});
+        jobs_->parallelFor(count, kShadowRebuildGrain, [this](int begin, int end, int worker) {
+            ShadowRebuildStats local;   // 块内先记在栈上，每块只碰一次共享的 vector
+            rebuildShadowRange(begin, end, local, *scratch_[(size_t)worker]);
+            ShadowRebuildStats& st = workerShadowStats_[(size_t)worker];
+            st.rebuilt += local.rebuilt;
+            st.reused += local.reused;
+            st.silhouetteMismatches += local.silhouetteMismatches;
+        });
+        for (const ShadowRebuildStats& st : workerShadowStats_) {
+            shadowStats_.rebuilt += st.rebuilt;
+            shadowStats_.reused += st.reused;
+            shadowStats_.silhouetteMismatches += st.silhouetteMismatches;
+        }
+    }
+
+    if (resized || shadowStats_.rebuilt > 0) {
+        shadowGrid_.build(shadowPlatforms_);
+        ++hullsVersion_;
+    }
+}
+
+void ShadowWorld::dropBallIfOutOfLight() {
+    if (!ball_.grounded()) return;
+
+    const glm::vec2 lc = light_.footprintCenter();
+    const float lr = light_.footprintRadius();
+
+    // 用“脚点”更符合你规则：脚离开光圈就掉
+    const glm::vec2 foot(ball_.pos.x, ball_.pos.y - ball_.radius);
+
+    // 边界给一点容差，防止贴边抖动
+    //const float eps = 1e-3f;
+    if (glm::distance(ball_.pos, lc)+ball_.radius > lr) {
+        ball_.drop();     // 这里 drop 必须清 grounded / support
+    }
+}
+
+
+void ShadowWorld::stickBallToSupportAfterLightMove() {
+    if (!ball_.grounded()) return;
+    const glm::vec2 lc = light_.footprintCenter();
+    const float lr = light_.footprintRadius();
+    const glm::vec2 foot(ball_.pos.x, ball_.pos.y - ball_.radius);
+
+    if (glm::distance(ball_.pos, lc)+ball_.radius > lr ) {
+        ball_.drop();
+        return;
+    }
+
+    const int objId = ball_.supportObjectId();
+    HullView sp;
+    if (!findPlatformByObjectId(objId, sp)) { ball_.drop(); return; }
+
+    const float minX = sp.minX;
+    const float maxX = sp.maxX;
+    const float w = std::max(maxX - minX, 1e-5f);
+
+    const float u = std::clamp(ball_.supportU(), 0.0f, 1.0f);
+    float x = minX + u * w;
+    if (x < minX || x > maxX) { ball_.drop(); return; }
+
+    //x = std::clamp(x, minX + 1e-3f, maxX - 1e-3f);
+    const float xQuery = std::clamp(x, minX, maxX);
+    float yTop = 0.0f;
+    if (!topYAtX(sp.verts, sp.count, xQuery, yTop)) { ball_.drop(); return; }
+
+    const glm::vec2 newPos(x, yTop + ball_.radius);
+
+    // 关键：先判断 newPos 是否出光圈，出就直接 drop，不要瞬移到 newPos
+    // const glm::vec2 lc = light_.footprintCenter();
+    // const float lr = light_.footprintRadius();
+    // if (glm::distance(newPos, lc) > lr) {
+    //     ball_.drop();
+    //     return;
+    // }
+
+    // 只有仍在光圈内，才真正“粘连到新位置”
+    ball_.pos = newPos;
+    ball_.vel.y = 0.0f;
+    ball_.forceGrounded(true);
+}
+
+
+RenderSnapshot ShadowWorld::captureSnapshot() const {
+    RenderSnapshot s;
+    s.ballPos = ball_.pos;
+    s.lightPos = light_.position;
+    s.lightFovDeg = light_.fovDeg;
+    s.cameraPos = camera_.position;
+    s.cameraTarget = camera_.target;
+    return s;
+}
+
+RenderSnapshot RenderSnapshot::lerp(const RenderSnapshot& a, const RenderSnapshot& b, float t) {
+    RenderSnapshot s;
+    s.ballPos = glm::mix(a.ballPos, b.ballPos, t);
+    s.lightPos = glm::mix(a.lightPos, b.lightPos, t);
+    s.lightFovDeg = glm::mix(a.lightFovDeg, b.lightFovDeg, t);
+    s.cameraPos = glm::mix(a.cameraPos, b.cameraPos, t);
+    s.cameraTarget = glm::mix(a.cameraTarget, b.cameraTarget, t);
+    return s;
+}
+
+void ShadowWorld::step(const InputState& in, float dt) {
+    SG_PROFILE_SCOPE("sim/step");
+    for (auto& s : scratch_) s->reset();   // 上一 tick 的临时分配全部作废
+    prevSnapshot_ = captureSnapshot();
+
+    {
+        SG_PROFILE_SCOPE("sim/light");
+        op_.update(in, dt);
+    }
+
+    {
+        SG_PROFILE_SCOPE("sim/rebuild");
+        rebuildShadowPlatforms();
+    }
+
+    const glm::vec2 lc = light_.footprintCenter();
+    const float lr = light_.footprintRadius();
+
+    // 先检查“当前球是否已出光圈”，出就 drop，别再粘连
+    // 只有仍在光圈内，并且 grounded，才做粘连/等比移动
+    dropBallIfOutOfLight();
+    // stickBallToSupportAfterLightMove();
+
+    // 只在光源真的移动时才做“等比粘连”，否则会把走出边缘的动作拉回去
+    bool lightMoved = false;
+    if (!hasLastLightPos_) {
+        hasLastLightPos_ = true;
+        lastLightPos_ = light_.position;
+    } else {
+        const float eps = 1e-4f;
+        lightMoved = glm::distance(light_.position, lastLightPos_) > eps;
+        lastLightPos_ = light_.position;
+    }
+
+    if (lightMoved) {
+        stickBallToSupportAfterLightMove();
+    }
+
+    // 物理现在会“边缘走出去就掉”，且“光圈外的平台无效”
+    {
+        SG_PROFILE_SCOPE("sim/physics");
+        ball_.updatePhysics(in, dt, shadowPlatforms_, shadowGrid_, lc, lr);
+    }
+
+    // death line
+    if (ball_.pos.y - ball_.radius <= deathY_) {
+        ++resetCount_;
+        resetLevel();
+    }
+
+    SG_PROFILE_SCOPE("sim/camera");
+    camera_.updateFollow(ball_.pos, dt);
+}
+
+std::uint64_t ShadowWorld::stateHash() const {
+    std::uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](const void* p, std::size_t n) {
+        const unsigned char* b = static_cast<const unsigned char*>(p);
+        for (std::size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ull; }
+    };
+    auto mixF = [&mix](float f) { std::uint32_t u; std::memcpy(&u, &f, 4); mix(&u, 4); };
+
+    mixF(ball_.pos.x);  mixF(ball_.pos.y);
+    mixF(ball_.vel.x);  mixF(ball_.vel.y);
+    const std::int32_t support = ball_.grounded() ? ball_.supportObjectId() : -2;
+    mix(&support, sizeof(support));
+    mixF(light_.position.x); mixF(light_.position.y); mixF(light_.position.z);
+    mixF(light_.fovDeg);
+    const std::int32_t resets = resetCount_;
+    mix(&resets, sizeof(resets));
+    return h;
+}
@@ -0,0 +1,160 @@
+// ============================================================================
+// File: src/world.hpp
+// 纯模拟：光源、盒子、阴影平台、球、相机跟随。不依赖 GL / GLFW，
+// 窗口版（Scene）和 headless 版都只通过 step(InputState, dt) 推进
+// ============================================================================
+#pragma once
+#ifndef WORLD_HPP
+#define WORLD_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "box.hpp"
+#include "camera.hpp"
+#include "frame_arena.hpp"
+#include "hull_grid.hpp"
+#include "hull_pool.hpp"
+#include "input.hpp"
+#include "LightSource.hpp"
+#include "people.hpp"
+#include "shadow.hpp"
+
+class JobSystem;
+
+// 渲染插值用的状态：每个 tick 开始前存一份，render 时在上一 tick 与当前之间插值
+struct RenderSnapshot {
+    glm::vec2 ballPos{0.0f};
+    glm::vec3 lightPos{0.0f};
+    float lightFovDeg = 75.0f;
+    glm::vec3 cameraPos{0.0f};
+    glm::vec3 cameraTarget{0.0f};
+
+    static RenderSnapshot lerp(const RenderSnapshot& a, const RenderSnapshot& b, float t);
+};
+
+class ShadowWorld final {
+public:
+    ShadowWorld();
+
+    // op_ 持有 &light_，不能拷贝/移动
+    ShadowWorld(const ShadowWorld&) = delete;
+    ShadowWorld& operator=(const ShadowWorld&) = delete;
+
+    // 推进一个固定 tick（dt 应为 FixedStepClock::tickDt）
+    void step(const InputState& in, float dt);
+    void resetLevel();
+
+    // 换一整套盒子 + 光源出生点（旧 hull 缓存全部作废），然后 resetLevel
+    void loadLevel(std::vector<BoxObject> objects, const glm::vec3& lightSpawn);
+
+    RenderSnapshot captureSnapshot() const;
+    const RenderSnapshot& prevSnapshot() const { return prevSnapshot_; }
+
+    const LightSource& light() const { return light_; }
+    const ShadowBall& ball() const { return ball_; }
+    const Camera& camera() const { return camera_; }
+    const std::vector<BoxObject>& objects() const { return objects_; }
+
+    // 槽位 i 对应 objects()[i]，退化的 hull count=0
+    const HullPool& platforms() const { return shadowPlatforms_; }
+    const HullGrid& grid() const { return shadowGrid_; }
+
+    // 最近一次 step 的阴影缓存命中情况
+    const ShadowRebuildStats& shadowStats() const { return shadowStats_; }
+    // hull 内容每变一次 +1：渲染端拿它判断要不要重传阴影 mesh
+    std::uint64_t hullsVersion() const { return hullsVersion_; }
+    // 槽位 slot 的 hull 最后一次是在哪个 hullsVersion 里重算的：
+    // 拷贝方记下自己拿到的 hullsVersion，下次只需拷比它新的槽位
+    std::uint64_t hullVersionOf(int slot) const { return shadowCache_[(size_t)slot].hullsVersion; }
+    // objects() 每换一次 +1：渲染端据此重传盒子实例数据
+    std::uint64_t objectsVersion() const { return objectsVersion_; }
+    // 掉出死亡线 / 手动 reset 的累计次数
+    int resetCount() const { return resetCount_; }
+    // 球 + 光源状态的 FNV-1a 摘要：两次回放结果对一下就知道是否逐位一致
+    std::uint64_t stateHash() const;
+
+    // ---- bench / 工具用：直接驱动阴影重建，不走 step ----
+    void setLightPosition(const glm::vec3& p);
+    void invalidateShadowCache();
+    // 只重算 light 或 box version 变过的 hull，其余沿用上一次结果
+    void rebuildShadowPlatforms();
+
+    // 设了以后 hull 重建按块分给 jobs 的 worker 并行做（不持有；nullptr = 串行）
+    // 槽位 i 固定对应 objects_[i]，结果与线程数无关
+    void setJobSystem(JobSystem* jobs);
+    JobSystem* jobSystem() const { return jobs_; }
+
+    // geom helpers
+    // 临时点集：调用方决定从哪个 memory_resource 分配（热路径上给 FrameArena，默认走全局堆）
+    using HullPoints = std::pmr::vector<glm::vec2>;
+    // 结果与 pts 用同一个 allocator
+    static HullPoints convexHull(HullPoints pts);
+    static HullPoints referenceHull(const glm::vec3& lightPos,
+                                    const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                    std::pmr::memory_resource* mr = std::pmr::get_default_resource());
+    static bool topYAtX(const glm::vec2* poly, int n, float x, float& outYTop);
+    // hull（CCW）与 referenceHull 是否为同一个多边形（同顶点集、容差 1e-4 相对）
+    static bool silhouetteMatchesReference(const glm::vec3& lightPos,
+                                           const glm::vec3& boxMin, const glm::vec3& boxMax,
+                                           const glm::vec2* hull, int n);
+
+private:
+    Camera camera_;
+    LightSource light_;
+    FlashlightOperator op_;
+    ShadowBall ball_;
+
+    std::vector<BoxObject> objects_;
+    std::uint64_t objectsVersion_ = 0;   // 改 objects_ 的地方都要 ++
+
+    // 完整阴影平台（稳定绑定）：槽位 i 对应 objects_[i]
+    HullPool shadowPlatforms_;
+    HullGrid shadowGrid_;          // broad phase，跟 shadowPlatforms_ 一起重建
+
+    // 阴影缓存：记录每个 hull 是用哪个 light/box version 算出来的
+    struct ShadowCacheEntry {
+        std::uint64_t lightVersion = 0;
+        std::uint32_t objectVersion = 0;
+        std::uint64_t hullsVersion = 0;   // 重算这一格的那次重建结束后的 hullsVersion_
+        bool valid = false;
+    };
+    std::vector<ShadowCacheEntry> shadowCache_;
+    ShadowRebuildStats shadowStats_;
+    std::uint64_t hullsVersion_ = 0;
+
+    JobSystem* jobs_ = nullptr;
+    std::vector<ShadowRebuildStats> workerShadowStats_;   // per-worker 计数，按 worker 顺序合并
+
+    // 每个 worker 一块临时内存（回退凸包的点集用）；step 开始时 reset
+    // FrameArena 不能移动，所以存指针
+    std::vector<std::unique_ptr<FrameArena>> scratch_;
+
+    // 重建 [begin, end) 号槽位，计数累加到 st，临时分配走 scratch
+    void rebuildShadowRange(int begin, int end, ShadowRebuildStats& st, FrameArena& scratch);
+    void ensureScratch(int workers);
+
+    RenderSnapshot prevSnapshot_;
+
+    glm::vec2 spawnBall_{-10.0f, 7.0f};
+    glm::vec3 spawnLight_{-6.0f, 10.0f, 12.0f};
+    float deathY_ = 0.0f;          // 与 BackgroundPlanes::deathY() 一致：地面
+    int resetCount_ = 0;
+
+    // 只在光源真的移动时才做“等比粘连”
+    bool hasLastLightPos_ = false;
+    glm::vec3 lastLightPos_{0.0f};
+
+    void initSceneObjects();
+
+    // sticky support logic
+    void dropBallIfOutOfLight();
+    void stickBallToSupportAfterLightMove();
+    bool findPlatformByObjectId(int objectId, HullView& out) const;
+};
+
+#endif // WORLD_HPP